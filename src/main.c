@@ -1,8 +1,18 @@
+#define _DEFAULT_SOURCE
+
 #include "raylib.h"
 #include <stdio.h>
 #include <math.h>
 #include <stdlib.h>
 #include <time.h>
+#include <string.h>
+#include <stdint.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <pthread.h>
+#include <sched.h>
 
 #define SCREEN_WIDTH 800
 #define SCREEN_HEIGHT 600
@@ -19,6 +29,48 @@
 
 #define PLATFORM_HEIGHT 32.0f
 
+#define REWIND_KEYFRAME_INTERVAL 60
+#define REWIND_SEGMENTS 32
+#define REWIND_SEGMENT_BYTES 16384
+#define REWIND_SCRUB_FAST 4
+
+#define LEVEL_MAGIC "MFLV"
+#define LEVEL_VERSION 2
+#define LEVEL_CHUNK_PLATFORMS 256
+#define LEVEL_DATA_ALIGN 4096
+#define LEVEL_WINDOW_HEIGHT (SCREEN_HEIGHT + 100 + PLATFORM_STREAM_AHEAD)
+#define PLATFORM_STREAM_AHEAD 200.0f
+
+#define GENERATOR_QUEUE_SIZE 64
+#define GENERATOR_LOOKAHEAD 800.0f
+#define GENERATOR_PREFILL 16
+
+#define INPUT_MAGIC "MFIN"
+#define INPUT_VERSION 2
+#define INPUT_LEFT 0x01
+#define INPUT_RIGHT 0x02
+#define INPUT_JUMP 0x04
+#define INPUT_REWIND 0x08
+#define INPUT_REWIND_FAST 0x10
+#define INPUT_NEW_GAME 0x20
+
+#define RENDER_SCALE_MAX 4
+#define RENDER_FRAME_BUDGET (1.0f / 60.0f)
+#define RENDER_WORK_BUDGET (RENDER_FRAME_BUDGET * 0.9f)
+#define RENDER_UPGRADE_DELAY 5.0f
+#define RENDER_DOWNGRADE_DELAY 0.5f
+#define RENDER_UPGRADE_DELAY_MAX 60.0f
+
+#ifndef WORLD_LANES
+#if defined(__AVX512F__)
+#define WORLD_LANES 16
+#elif defined(__AVX__)
+#define WORLD_LANES 8
+#else
+#define WORLD_LANES 4
+#endif
+#endif
+
 typedef enum
 {
     MENU,
@@ -76,14 +128,223 @@ typedef struct
     bool active;
 } Platform;
 
+typedef struct
+{
+    Player player;
+    Platform platforms[MAX_PLATFORMS];
+    Camera2D camera;
+    int score;
+    float gameSpeed;
+    float startYPosition;
+    int levelCursor;
+    uint32_t generatorSeed;
+} GameWorld;
+
+#define REWIND_WORLD_WORDS (sizeof(GameWorld) / sizeof(uint32_t))
+#define REWIND_MAX_DELTA_BYTES (REWIND_WORLD_WORDS * 6)
+
+typedef struct
+{
+    GameWorld keyframe;
+    int ticks;
+    int used;
+    uint16_t deltaOffset[REWIND_KEYFRAME_INTERVAL];
+    unsigned char deltas[REWIND_SEGMENT_BYTES];
+} RewindSegment;
+
+typedef struct
+{
+    int moveX;
+    bool jump;
+    bool rewind;
+    bool rewindFast;
+    bool newGame;
+    float dt;
+} InputFrame;
+
+typedef struct
+{
+    char magic[4];
+    uint32_t version;
+    uint32_t seed;
+    uint32_t tickCount;
+} InputHeader;
+
+typedef struct
+{
+    int32_t score;
+    uint32_t ticks;
+    float x;
+    float y;
+} InputCheckpoint;
+
+typedef struct
+{
+    FILE *file;
+    bool recording;
+    bool replaying;
+    bool scripted;
+    bool finished;
+    bool diverged;
+    bool newGamePending;
+    bool gameStarted;
+    uint32_t seed;
+    uint32_t tick;
+    uint32_t tickCount;
+    uint32_t gameStartTick;
+    InputCheckpoint checkpoint;
+} InputSession;
+
+typedef struct
+{
+    RenderTexture2D target;
+    int divisor;
+    bool autoScale;
+    bool hudNative;
+    float updateTime;
+    float drawTime;
+    float averageUpdateTime;
+    float averageDrawTime;
+    float cooldown;
+    float stableTime;
+    float overBudgetTime;
+    float upgradeDelay;
+} RenderScaler;
+
+typedef struct
+{
+    char magic[4];
+    uint32_t version;
+    uint32_t platformCount;
+    uint32_t chunkSize;
+    uint32_t chunkCount;
+    uint32_t dataOffset;
+    uint32_t maxWindowPlatforms;
+} LevelHeader;
+
+typedef struct
+{
+    float topY;
+    float bottomY;
+} LevelChunk;
+
+typedef struct
+{
+    float x;
+    float y;
+    float width;
+    int32_t type;
+} LevelPlatform;
+
+typedef struct
+{
+    unsigned char *map;
+    size_t mapSize;
+    const LevelHeader *header;
+    const LevelChunk *chunks;
+    const LevelPlatform *platforms;
+    uint32_t firstChunk;
+    uint32_t prefetchedChunk;
+    uint32_t checkedPlatforms;
+    bool overflowWarned;
+    bool corrupt;
+} Level;
+
+typedef struct
+{
+    LevelPlatform platform;
+    uint32_t epoch;
+} GeneratedPlatform;
+
+typedef struct
+{
+    GeneratedPlatform items[GENERATOR_QUEUE_SIZE];
+    uint32_t head;
+    uint32_t tail;
+    uint32_t epoch;
+    float resetX;
+    float resetY;
+    uint32_t resetSeed;
+    float horizonY;
+    float generatedY;
+    bool demand;
+    bool sleeping;
+    bool running;
+    LevelPlatform prefill[GENERATOR_PREFILL];
+    int prefillCursor;
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+    pthread_t thread;
+} PlatformGenerator;
+
+typedef struct
+{
+    LevelPlatform next;
+    float lastX;
+    float lastY;
+    uint32_t seed;
+} PlatformStream;
+
+typedef float LaneFloat __attribute__((vector_size(WORLD_LANES * sizeof(float))));
+typedef int32_t LaneInt __attribute__((vector_size(WORLD_LANES * sizeof(int32_t))));
+typedef uint32_t LaneUInt __attribute__((vector_size(WORLD_LANES * sizeof(uint32_t))));
+
+#define LANE_SELECT(mask, a, b) ((LaneFloat)(((mask) & (LaneInt)(a)) | (~(mask) & (LaneInt)(b))))
+#define LANE_SELECT_INT(mask, a, b) (((mask) & (a)) | (~(mask) & (b)))
+
+typedef struct
+{
+    LaneFloat positionX;
+    LaneFloat positionY;
+    LaneFloat velocityX;
+    LaneFloat velocityY;
+    LaneFloat hitboxX;
+    LaneFloat hitboxY;
+    LaneFloat previousHitboxX;
+    LaneFloat previousHitboxY;
+    LaneFloat gameSpeed;
+    LaneFloat startYPosition;
+    LaneInt onGround;
+    LaneInt facingRight;
+    LaneInt state;
+    LaneInt previousState;
+    LaneInt currentPlatform;
+    LaneInt score;
+    LaneFloat cameraY;
+    LaneInt alive;
+
+    LaneFloat platformX[MAX_PLATFORMS];
+    LaneFloat platformY[MAX_PLATFORMS];
+    LaneFloat platformWidth[MAX_PLATFORMS];
+    LaneInt platformType[MAX_PLATFORMS];
+    LaneInt platformActive[MAX_PLATFORMS];
+    LaneInt jumped;
+
+    LaneFloat nextY;
+    PlatformStream streams[WORLD_LANES];
+} WorldBatch;
+
+typedef struct
+{
+    RewindSegment segments[REWIND_SEGMENTS];
+    int oldest;
+    int count;
+    GameWorld last;
+    bool rewinding;
+    int cursorSegment;
+    int cursorTick;
+} RewindBuffer;
+
 GameState gameState = MENU;
-Player player;
-Platform platforms[MAX_PLATFORMS];
-Camera2D camera = {0};
-int score = 0;
+GameWorld world = {.gameSpeed = 1.0f};
 int highScore = 0;
-float gameSpeed = 1.0f;
-float startYPosition = 0;
+InputFrame input;
+InputSession session;
+RewindBuffer rewindBuffer;
+Level level;
+PlatformGenerator generator;
+RenderScaler renderScaler = {.divisor = 1, .autoScale = true, .hudNative = true,
+                              .upgradeDelay = RENDER_UPGRADE_DELAY};
 
 Texture2D menuBackgroundTexture;
 Texture2D startButtonTexture;
@@ -97,11 +358,38 @@ Texture2D gameOverTexture;
 
 bool LoadGameAssets();
 void UnloadGameAssets();
+bool LoadLevelFile(const char *path);
+void UnloadLevelFile();
+bool SaveLevelFile(const char *path, int platformCount, uint32_t seed);
+void StreamLevel(float topLimit, float bottomLimit);
+LevelPlatform NextPlatform(float *lastX, float *lastY, uint32_t *seed);
+bool StartPlatformGenerator();
+void StopPlatformGenerator();
+void ResetPlatformGenerator(float refX, float refY, uint32_t seed);
+void ConsumeGeneratedPlatforms(float topLimit, float bottomLimit);
 void InitPlayer();
 void InitPlatforms();
 void GeneratePlatform(float refX, float refY);
+bool StepPlayer(GameWorld *w, int moveX, bool jump, float dt);
 void UpdatePlayer();
+void StartGame();
+bool StartInputRecording(const char *path, uint32_t seed);
+bool StartInputReplay(const char *path);
+void StopInputSession();
+static InputCheckpoint CurrentCheckpoint();
+static bool VerifyCheckpoint();
+void ReadInput();
+bool StepWorld(GameWorld *w, PlatformStream *stream, int moveX, bool jump, float dt);
+void LoadWorldBatchLane(WorldBatch *batch, int lane, const GameWorld *w, const PlatformStream *stream);
+void StoreWorldBatchLane(const WorldBatch *batch, int lane, GameWorld *w, PlatformStream *stream);
+void StepWorldBatch(WorldBatch *b, const LaneInt *moveX, const LaneInt *jump, float dt);
+int RunBatchEvaluation(int worldCount, int ticks);
+static void ScriptedInput(uint32_t worldIndex, uint32_t tick, int *moveX, bool *jump);
+static void ScriptedInputBatch(const LaneUInt *worldIndex, const LaneUInt *tick, LaneInt *moveX, LaneInt *jump);
+void StepCamera(GameWorld *w);
 void UpdateGameCamera();
+float EvictPlatforms(GameWorld *w);
+bool PlayerFellOff(const GameWorld *w);
 void UpdatePlatforms();
 void CheckGameOver();
 void DrawParallaxBackground(Texture2D texture, float parallaxFactor);
@@ -109,8 +397,21 @@ void DrawPlayer();
 void DrawPlatforms();
 void DrawMenu();
 void DrawGameOver();
+void DrawGameOverOverlay(int width, int height);
 void DrawHUD();
+void DrawWorld(Camera2D view);
+void DrawInterface();
+void SetRenderDivisor(int divisor);
+void UpdateRenderScale();
+void RenderLowResolutionWorld();
+void DrawGameplay();
 void UpdateAnimation(Animation *anim, float deltaTime, bool reset);
+void RewindReset();
+void RewindRecord();
+void RewindStepBack();
+void RewindStepForward();
+void RewindResume();
+bool UpdateRewind();
 
 
 bool LoadGameAssets()
@@ -121,9 +422,9 @@ bool LoadGameAssets()
     platform1Texture = LoadTexture("assets/gameplay/plataforma1.png");
     platform2Texture = LoadTexture("assets/gameplay/plataforma2.png");
     platform3Texture = LoadTexture("assets/gameplay/plataforma3.png");
-    player.idleAnim.texture = LoadTexture("assets/player/player_Idle.png");
-    player.walkAnim.texture = LoadTexture("assets/player/player_walk.png");
-    player.jumpAnim.texture = LoadTexture("assets/player/player_Jump.png");
+    world.player.idleAnim.texture = LoadTexture("assets/player/player_Idle.png");
+    world.player.walkAnim.texture = LoadTexture("assets/player/player_walk.png");
+    world.player.jumpAnim.texture = LoadTexture("assets/player/player_Jump.png");
     gameOverTexture = LoadTexture("assets/gameplay/dead.png");
 
     platformTextures[PLATFORM_TYPE_1] = platform1Texture;
@@ -161,17 +462,17 @@ bool LoadGameAssets()
         TraceLog(LOG_WARNING, "AVISO: assets/gameplay/plataforma3.png nao carregado");
         allLoaded = false;
     }
-    if (player.idleAnim.texture.id == 0)
+    if (world.player.idleAnim.texture.id == 0)
     {
         TraceLog(LOG_WARNING, "AVISO: assets/player/player_Idle.png nao carregado");
         allLoaded = false;
     }
-    if (player.walkAnim.texture.id == 0)
+    if (world.player.walkAnim.texture.id == 0)
     {
         TraceLog(LOG_WARNING, "AVISO: assets/player/player_walk.png nao carregado");
         allLoaded = false;
     }
-    if (player.jumpAnim.texture.id == 0)
+    if (world.player.jumpAnim.texture.id == 0)
     {
         TraceLog(LOG_WARNING, "AVISO: assets/player/player_Jump.png nao carregado");
         allLoaded = false;
@@ -193,70 +494,81 @@ void UnloadGameAssets()
     UnloadTexture(platform1Texture);
     UnloadTexture(platform2Texture);
     UnloadTexture(platform3Texture);
-    UnloadTexture(player.idleAnim.texture);
-    UnloadTexture(player.walkAnim.texture);
-    UnloadTexture(player.jumpAnim.texture);
+    UnloadTexture(world.player.idleAnim.texture);
+    UnloadTexture(world.player.walkAnim.texture);
+    UnloadTexture(world.player.jumpAnim.texture);
     UnloadTexture(gameOverTexture);
 }
 
 void InitPlayer()
 {
     
-    Platform initialPlatform = platforms[0];
+    Platform initialPlatform = world.platforms[0];
 
-    player.position = (Vector2){
+    world.player.position = (Vector2){
         initialPlatform.rect.x + initialPlatform.rect.width / 2.0f,
         initialPlatform.rect.y - 2.0f
     };
 
-    player.velocity = (Vector2){0, 0};
-    player.hitbox = (Rectangle){
-        player.position.x - PLAYER_HITBOX_WIDTH / 2.0f, 
-        player.position.y - PLAYER_HITBOX_HEIGHT,
+    world.player.velocity = (Vector2){0, 0};
+    world.player.hitbox = (Rectangle){
+        world.player.position.x - PLAYER_HITBOX_WIDTH / 2.0f, 
+        world.player.position.y - PLAYER_HITBOX_HEIGHT,
         PLAYER_HITBOX_WIDTH,
         PLAYER_HITBOX_HEIGHT};
 
-    player.previousHitbox = player.hitbox;
-    player.state = IDLE;
-    player.prevState = IDLE;
-    player.facingRight = true;
-    player.onGround = true; 
-    player.currentPlatform = 0;
-
-    player.idleAnim.frames = 5;
-    player.idleAnim.frameTime = 0.15f;
-    player.idleAnim.currentFrame = 0;
-    player.idleAnim.elapsedTime = 0.0f;
-    player.idleAnim.frameWidth = player.idleAnim.texture.width / player.idleAnim.frames;
-    player.idleAnim.frameHeight = player.idleAnim.texture.height;
-
-    player.walkAnim.frames = 8;
-    player.walkAnim.frameTime = 0.1f;
-    player.walkAnim.currentFrame = 0;
-    player.walkAnim.elapsedTime = 0.0f;
-    player.walkAnim.frameWidth = player.walkAnim.texture.width / player.walkAnim.frames;
-    player.walkAnim.frameHeight = player.walkAnim.texture.height;
-
-    player.jumpAnim.frames = 8;
-    player.jumpAnim.frameTime = 0.1f;
-    player.jumpAnim.currentFrame = 0;
-    player.jumpAnim.elapsedTime = 0.0f;
-    player.jumpAnim.frameWidth = player.jumpAnim.texture.width / player.jumpAnim.frames;
-    player.jumpAnim.frameHeight = player.jumpAnim.texture.height;
-
-    player.platformsHit = 0;
-    score = 0;
-    startYPosition = player.position.y - PLAYER_HITBOX_HEIGHT; 
+    world.player.previousHitbox = world.player.hitbox;
+    world.player.state = IDLE;
+    world.player.prevState = IDLE;
+    world.player.facingRight = true;
+    world.player.onGround = true; 
+    world.player.currentPlatform = 0;
+
+    world.player.idleAnim.frames = 5;
+    world.player.idleAnim.frameTime = 0.15f;
+    world.player.idleAnim.currentFrame = 0;
+    world.player.idleAnim.elapsedTime = 0.0f;
+    world.player.idleAnim.frameWidth = world.player.idleAnim.texture.width / world.player.idleAnim.frames;
+    world.player.idleAnim.frameHeight = world.player.idleAnim.texture.height;
+
+    world.player.walkAnim.frames = 8;
+    world.player.walkAnim.frameTime = 0.1f;
+    world.player.walkAnim.currentFrame = 0;
+    world.player.walkAnim.elapsedTime = 0.0f;
+    world.player.walkAnim.frameWidth = world.player.walkAnim.texture.width / world.player.walkAnim.frames;
+    world.player.walkAnim.frameHeight = world.player.walkAnim.texture.height;
+
+    world.player.jumpAnim.frames = 8;
+    world.player.jumpAnim.frameTime = 0.1f;
+    world.player.jumpAnim.currentFrame = 0;
+    world.player.jumpAnim.elapsedTime = 0.0f;
+    world.player.jumpAnim.frameWidth = world.player.jumpAnim.texture.width / world.player.jumpAnim.frames;
+    world.player.jumpAnim.frameHeight = world.player.jumpAnim.texture.height;
+
+    world.player.platformsHit = 0;
+    world.score = 0;
+    world.startYPosition = world.player.position.y - PLAYER_HITBOX_HEIGHT; 
 }
 
 void InitPlatforms()
 {
     for (int i = 0; i < MAX_PLATFORMS; i++)
     {
-        platforms[i].active = false;
+        world.platforms[i].active = false;
+    }
+
+    if (level.map != NULL)
+    {
+        float baseY = level.platforms[0].y;
+        world.levelCursor = 0;
+        level.firstChunk = 0;
+        level.prefetchedChunk = 0;
+        level.overflowWarned = false;
+        StreamLevel(baseY - SCREEN_HEIGHT - PLATFORM_STREAM_AHEAD, baseY + SCREEN_HEIGHT);
+        return;
     }
 
-    platforms[0] = (Platform){
+    world.platforms[0] = (Platform){
         .rect = {
             SCREEN_WIDTH / 2.0f - 100,
             SCREEN_HEIGHT - 100, 
@@ -269,372 +581,1701 @@ void InitPlatforms()
     
     float lastY = SCREEN_HEIGHT - 100; 
     float lastX = SCREEN_WIDTH / 2.0f; 
+    world.generatorSeed = (uint32_t)GetRandomValue(0, 0x7fffffff);
     for (int i = 1; i < 8; i++)
     {
-        int gap = GetRandomValue(PLATFORM_MIN_GAP, PLATFORM_MAX_GAP);
-        lastY -= gap;
+        LevelPlatform next = NextPlatform(&lastX, &lastY, &world.generatorSeed);
+        world.platforms[i] = (Platform){
+            .rect = {next.x, next.y, next.width, PLATFORM_HEIGHT},
+            .type = (PlatformType)next.type,
+            .active = true};
+    }
 
-        int offsetX = GetRandomValue(-MAX_HORIZONTAL_GAP, MAX_HORIZONTAL_GAP);
-        lastX += offsetX;
+    ResetPlatformGenerator(lastX, lastY, world.generatorSeed);
+}
 
-        if (lastX < 50)
-            lastX = 50;
-        else if (lastX > SCREEN_WIDTH - 50)
-            lastX = SCREEN_WIDTH - 50;
+static int PlatformRandom(uint32_t *seed, int min, int max)
+{
+    *seed = *seed * 1664525u + 1013904223u;
+    return min + (int)((*seed >> 8) % (uint32_t)(max - min + 1));
+}
 
-        float width = GetRandomValue(80, 180);
+LevelPlatform NextPlatform(float *lastX, float *lastY, uint32_t *seed)
+{
+    *lastY -= PlatformRandom(seed, PLATFORM_MIN_GAP, PLATFORM_MAX_GAP);
+    *lastX += PlatformRandom(seed, -MAX_HORIZONTAL_GAP, MAX_HORIZONTAL_GAP);
 
-        platforms[i] = (Platform){
-            .rect = {lastX - width / 2.0f, lastY, width, PLATFORM_HEIGHT},
-            .type = (PlatformType)GetRandomValue(0, 2),
-            .active = true};
-    }
+    if (*lastX < 50)
+        *lastX = 50;
+    else if (*lastX > SCREEN_WIDTH - 50)
+        *lastX = SCREEN_WIDTH - 50;
+
+    float width = PlatformRandom(seed, 80, 180);
+    return (LevelPlatform){*lastX - width / 2.0f, *lastY, width, PlatformRandom(seed, 0, 2)};
 }
 
 void GeneratePlatform(float refX, float refY)
 {
+    if (level.map != NULL || generator.running)
+        return;
+
     for (int i = 0; i < MAX_PLATFORMS; i++)
     {
-        if (!platforms[i].active)
+        if (!world.platforms[i].active)
         {
-            int gap = GetRandomValue(PLATFORM_MIN_GAP, PLATFORM_MAX_GAP);
-            float newY = refY - gap;
-
-            int offsetX = GetRandomValue(-MAX_HORIZONTAL_GAP, MAX_HORIZONTAL_GAP);
-            float newX = refX + offsetX;
-
-            if (newX < 50)
-                newX = 50;
-            else if (newX > SCREEN_WIDTH - 50)
-                newX = SCREEN_WIDTH - 50;
-
-            float width = GetRandomValue(80, 180);
-
-            platforms[i] = (Platform){
-                .rect = {newX - width / 2.0f, newY, width, PLATFORM_HEIGHT},
-                .type = (PlatformType)GetRandomValue(0, 2),
+            LevelPlatform next = NextPlatform(&refX, &refY, &world.generatorSeed);
+            world.platforms[i] = (Platform){
+                .rect = {next.x, next.y, next.width, PLATFORM_HEIGHT},
+                .type = (PlatformType)next.type,
                 .active = true};
             return;
         }
     }
 }
 
-void UpdateAnimation(Animation *anim, float deltaTime, bool reset)
+bool LoadLevelFile(const char *path)
 {
-    if (reset)
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
     {
-        anim->currentFrame = 0;
-        anim->elapsedTime = 0.0f;
-        return;
+        TraceLog(LOG_WARNING, "AVISO: nivel %s nao encontrado", path);
+        return false;
     }
-    anim->elapsedTime += deltaTime;
-    if (anim->elapsedTime >= anim->frameTime)
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(LevelHeader))
     {
-        anim->currentFrame = (anim->currentFrame + 1) % anim->frames;
-        anim->elapsedTime = 0.0f;
+        TraceLog(LOG_WARNING, "AVISO: nivel %s invalido", path);
+        close(fd);
+        return false;
     }
-}
-
-
-void UpdatePlayer()
-{
-    player.previousHitbox = player.hitbox;
-    player.prevState = player.state;
 
-    bool moving = false;
-    if (IsKeyDown(KEY_A) || IsKeyDown(KEY_LEFT))
+    unsigned char *map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED)
     {
-        player.velocity.x = -PLAYER_SPEED * gameSpeed;
-        player.facingRight = false;
-        moving = true;
+        TraceLog(LOG_WARNING, "AVISO: nivel %s nao mapeado", path);
+        return false;
     }
-    else if (IsKeyDown(KEY_D) || IsKeyDown(KEY_RIGHT))
+
+    const LevelHeader *header = (const LevelHeader *)map;
+    size_t size = (size_t)st.st_size;
+    size_t indexEnd = sizeof(LevelHeader) + (size_t)header->chunkCount * sizeof(LevelChunk);
+    bool valid = memcmp(header->magic, LEVEL_MAGIC, 4) == 0 &&
+                 header->version == LEVEL_VERSION &&
+                 header->platformCount > 0 &&
+                 header->chunkSize > 0 &&
+                 header->chunkCount == (header->platformCount + header->chunkSize - 1) / header->chunkSize &&
+                 header->dataOffset % sizeof(LevelPlatform) == 0 &&
+                 header->dataOffset >= indexEnd &&
+                 header->dataOffset + (size_t)header->platformCount * sizeof(LevelPlatform) <= size;
+
+    const LevelChunk *chunks = (const LevelChunk *)(map + sizeof(LevelHeader));
+    for (uint32_t i = 1; valid && i < header->chunkCount; i++)
     {
-        player.velocity.x = PLAYER_SPEED * gameSpeed;
-        player.facingRight = true;
-        moving = true;
+        if (chunks[i].bottomY > chunks[i - 1].topY)
+            valid = false;
     }
-    else
+
+    if (!valid)
     {
-        player.velocity.x = 0;
+        TraceLog(LOG_WARNING, "AVISO: nivel %s com formato invalido", path);
+        munmap(map, size);
+        return false;
     }
 
-
-    if (IsKeyPressed(KEY_SPACE) && player.onGround)
+    if (header->maxWindowPlatforms > MAX_PLATFORMS)
     {
-        player.velocity.y = JUMP_FORCE;
-        player.onGround = false;
-        player.state = JUMPING;
-
-        Platform *current = &platforms[player.currentPlatform];
-        float refX = current->rect.x + current->rect.width / 2.0f;
-        float refY = current->rect.y;
-        GeneratePlatform(refX, refY);
+        TraceLog(LOG_WARNING, "AVISO: nivel %s tem %u plataformas em %d px (maximo %d)",
+                 path, header->maxWindowPlatforms, (int)LEVEL_WINDOW_HEIGHT, MAX_PLATFORMS);
+        munmap(map, size);
+        return false;
     }
 
+    UnloadLevelFile();
+    level.map = map;
+    level.mapSize = size;
+    level.header = header;
+    level.chunks = chunks;
+    level.platforms = (const LevelPlatform *)(map + header->dataOffset);
+    level.firstChunk = 0;
+    level.prefetchedChunk = 0;
+    madvise(map, size, MADV_SEQUENTIAL);
+
+    TraceLog(LOG_INFO, "Nivel %s: %u plataformas em %u blocos", path, header->platformCount, header->chunkCount);
+    return true;
+}
 
-    player.velocity.y += GRAVITY * GetFrameTime() * gameSpeed;
-
-
-    if (player.velocity.y > MAX_FALL_SPEED)
+void UnloadLevelFile()
+{
+    if (level.map != NULL)
     {
-        player.velocity.y = MAX_FALL_SPEED;
+        munmap(level.map, level.mapSize);
     }
+    level = (Level){0};
+}
 
+static uint32_t LevelWindowDensity(const LevelPlatform *platforms, uint32_t count)
+{
+    uint32_t densest = 0;
+    uint32_t top = 0;
 
-    player.position.x += player.velocity.x * GetFrameTime();
-    player.position.y += player.velocity.y * GetFrameTime();
-
-    player.hitbox.x = player.position.x - PLAYER_HITBOX_WIDTH / 2.0f;
-    player.hitbox.y = player.position.y - PLAYER_HITBOX_HEIGHT;
-
-   
-    player.onGround = false;
-
-    if (player.velocity.y >= 0)
+    for (uint32_t bottom = 0; bottom < count; bottom++)
     {
-        for (int i = 0; i < MAX_PLATFORMS; i++)
-        {
-            if (!platforms[i].active)
-                continue;
-
-
-            Rectangle playerFeetArea = {
-                player.hitbox.x,
-                player.hitbox.y + player.hitbox.height - 10, 
-                player.hitbox.width,
-                15 
-            };
+        if (top < bottom)
+            top = bottom;
+        while (top + 1 < count && platforms[top + 1].y >= platforms[bottom].y - LEVEL_WINDOW_HEIGHT)
+            top++;
+        if (top - bottom + 1 > densest)
+            densest = top - bottom + 1;
+    }
 
-            if (CheckCollisionRecs(playerFeetArea, platforms[i].rect))
-            {
+    return densest;
+}
 
-                if (player.previousHitbox.y + player.previousHitbox.height <= platforms[i].rect.y + 1.0f) 
-                {
-                    player.position.y = platforms[i].rect.y;
-                    player.velocity.y = 0;
-                    player.onGround = true;
-                    player.currentPlatform = i;
-                    break; 
-                }
-            }
-        }
+bool SaveLevelFile(const char *path, int platformCount, uint32_t seed)
+{
+    if (platformCount <= 0)
+        return false;
+
+    LevelHeader header = {.version = LEVEL_VERSION,
+                          .platformCount = (uint32_t)platformCount,
+                          .chunkSize = LEVEL_CHUNK_PLATFORMS};
+    memcpy(header.magic, LEVEL_MAGIC, 4);
+    header.chunkCount = (header.platformCount + header.chunkSize - 1) / header.chunkSize;
+    size_t indexEnd = sizeof(LevelHeader) + header.chunkCount * sizeof(LevelChunk);
+    header.dataOffset = (uint32_t)((indexEnd + LEVEL_DATA_ALIGN - 1) / LEVEL_DATA_ALIGN * LEVEL_DATA_ALIGN);
+
+    LevelChunk *chunks = calloc(header.chunkCount, sizeof(LevelChunk));
+    LevelPlatform *platforms = malloc((size_t)platformCount * sizeof(LevelPlatform));
+    if (chunks == NULL || platforms == NULL)
+    {
+        free(chunks);
+        free(platforms);
+        return false;
     }
 
-    if (!player.onGround)
+    float lastY = SCREEN_HEIGHT - 100;
+    float lastX = SCREEN_WIDTH / 2.0f;
+    platforms[0] = (LevelPlatform){lastX - 100, lastY, 200, PLATFORM_TYPE_1};
+    for (int i = 1; i < platformCount; i++)
     {
-        player.state = JUMPING;
+        platforms[i] = NextPlatform(&lastX, &lastY, &seed);
     }
-    else if (moving)
+
+    for (uint32_t c = 0; c < header.chunkCount; c++)
     {
-        player.state = WALKING;
+        uint32_t first = c * header.chunkSize;
+        uint32_t last = first + header.chunkSize < header.platformCount ? first + header.chunkSize : header.platformCount;
+        chunks[c] = (LevelChunk){platforms[last - 1].y, platforms[first].y};
     }
-    else
+
+    header.maxWindowPlatforms = LevelWindowDensity(platforms, header.platformCount);
+    if (header.maxWindowPlatforms > MAX_PLATFORMS)
     {
-        player.state = IDLE;
+        TraceLog(LOG_WARNING, "AVISO: %u plataformas em %d px excede o maximo de %d",
+                 header.maxWindowPlatforms, (int)LEVEL_WINDOW_HEIGHT, MAX_PLATFORMS);
+        free(chunks);
+        free(platforms);
+        return false;
     }
 
- 
-    bool resetAnimation = (player.prevState != player.state);
-    switch (player.state)
+    FILE *file = fopen(path, "wb");
+    if (file == NULL)
     {
-    case IDLE:
-        UpdateAnimation(&player.idleAnim, GetFrameTime() * gameSpeed, resetAnimation);
-        break;
-    case WALKING:
-        UpdateAnimation(&player.walkAnim, GetFrameTime() * gameSpeed, resetAnimation);
-        break;
-    case JUMPING:
-        UpdateAnimation(&player.jumpAnim, GetFrameTime() * gameSpeed, resetAnimation);
-        break;
+        TraceLog(LOG_WARNING, "AVISO: nao foi possivel criar %s", path);
+        free(chunks);
+        free(platforms);
+        return false;
     }
 
-    float heightDifference = startYPosition - (player.hitbox.y);
-    if (heightDifference > score)
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1 &&
+              fwrite(chunks, sizeof(LevelChunk), header.chunkCount, file) == header.chunkCount;
+    for (size_t pad = indexEnd; ok && pad < header.dataOffset; pad++)
     {
-        score = (int)heightDifference;
+        ok = fputc(0, file) != EOF;
     }
+    ok = ok && fwrite(platforms, sizeof(LevelPlatform), (size_t)platformCount, file) == (size_t)platformCount;
+    ok = (fclose(file) == 0) && ok;
 
-    gameSpeed = 1.0f + (score * 0.0005f);
-    if (gameSpeed > 2.5f)
-        gameSpeed = 2.5f;
+    free(chunks);
+    free(platforms);
+
+    if (!ok)
+    {
+        TraceLog(LOG_WARNING, "AVISO: erro ao gravar %s", path);
+    }
+    else
+    {
+        TraceLog(LOG_INFO, "Nivel %s: %d plataformas, semente %u", path, platformCount, seed);
+    }
+    return ok;
 }
 
-void UpdateGameCamera()
+static void AdviseLevelChunk(uint32_t chunk, int advice)
 {
-    
-    camera.target.x = player.position.x;
-    camera.target.y = player.position.y - SCREEN_HEIGHT / 3.0f; 
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    size_t start = level.header->dataOffset + (size_t)chunk * level.header->chunkSize * sizeof(LevelPlatform);
+    size_t end = start + (size_t)level.header->chunkSize * sizeof(LevelPlatform);
+    if (end > level.mapSize)
+        end = level.mapSize;
 
-    if (camera.target.y > startYPosition - SCREEN_HEIGHT / 2.0f + 50)
+    if (advice == MADV_DONTNEED)
+    {
+        start = (start + page - 1) / page * page;
+        end = end / page * page;
+    }
+    else
     {
-        camera.target.y = startYPosition - SCREEN_HEIGHT / 2.0f + 50;
+        start = start / page * page;
     }
 
-    camera.offset = (Vector2){SCREEN_WIDTH / 2.0f, SCREEN_HEIGHT / 2.0f};
+    if (start < end)
+    {
+        madvise(level.map + start, end - start, advice);
+    }
 }
 
-
-void UpdatePlatforms()
+static bool CheckLevelChunk(uint32_t chunk)
 {
-    float bottomLimit = camera.target.y + SCREEN_HEIGHT / 2.0f + 100;
-    for (int i = 0; i < MAX_PLATFORMS; i++)
-    {
-        if (platforms[i].active && platforms[i].rect.y > bottomLimit)
-        {
-            platforms[i].active = false;
-        }
-    }
+    if (level.corrupt)
+        return false;
 
-    float highestActivePlatformY = -INFINITY;
-    for (int i = 0; i < MAX_PLATFORMS; i++)
+    uint32_t first = chunk * level.header->chunkSize;
+    uint32_t last = first + level.header->chunkSize;
+    if (last > level.header->platformCount)
+        last = level.header->platformCount;
+
+    float previousY = first > 0 ? level.platforms[first - 1].y : INFINITY;
+    for (uint32_t i = first; i < last; i++)
     {
-        if (platforms[i].active)
+        float y = level.platforms[i].y;
+        if (!(y <= previousY && y >= level.chunks[chunk].topY && y <= level.chunks[chunk].bottomY))
         {
-            if (platforms[i].rect.y < highestActivePlatformY || highestActivePlatformY == -INFINITY)
-            {
-                highestActivePlatformY = platforms[i].rect.y;
-            }
+            TraceLog(LOG_WARNING, "AVISO: plataforma %u do nivel fora de ordem, leitura interrompida", i);
+            level.corrupt = true;
+            return false;
         }
+        previousY = y;
     }
 
-    if (highestActivePlatformY == -INFINITY || highestActivePlatformY > camera.target.y - SCREEN_HEIGHT / 2.0f + 150)
+    level.checkedPlatforms = last;
+    return true;
+}
+
+void StreamLevel(float topLimit, float bottomLimit)
+{
+    uint32_t count = level.header->platformCount;
+    int slot = 0;
+
+    while ((uint32_t)world.levelCursor < count)
     {
-        float refX = SCREEN_WIDTH / 2.0f;
-        if (highestActivePlatformY != -INFINITY)
+        if ((uint32_t)world.levelCursor >= level.checkedPlatforms &&
+            !CheckLevelChunk((uint32_t)world.levelCursor / level.header->chunkSize))
+            break;
+
+        const LevelPlatform *source = &level.platforms[world.levelCursor];
+        if (source->y < topLimit)
+            break;
+
+        if (source->y <= bottomLimit)
         {
-            for (int i = 0; i < MAX_PLATFORMS; i++)
+            while (slot < MAX_PLATFORMS && world.platforms[slot].active)
+                slot++;
+            if (slot == MAX_PLATFORMS)
             {
-                if (platforms[i].active && platforms[i].rect.y == highestActivePlatformY)
+                if (!level.overflowWarned)
                 {
-                    refX = platforms[i].rect.x + platforms[i].rect.width / 2.0f;
-                    break;
+                    TraceLog(LOG_WARNING, "AVISO: sem espaco para a plataforma %d do nivel", world.levelCursor);
+                    level.overflowWarned = true;
                 }
+                break;
             }
-        }
-        else
-        {
-            highestActivePlatformY = camera.target.y - SCREEN_HEIGHT / 2.0f;
-        }
 
-        for (int j = 0; j < 5; j++)
-        {
-            GeneratePlatform(refX, highestActivePlatformY - (j * (PLATFORM_MAX_GAP + PLATFORM_HEIGHT)));
+            world.platforms[slot] = (Platform){
+                .rect = {source->x, source->y, source->width, PLATFORM_HEIGHT},
+                .type = (source->type >= 0 && source->type <= 2) ? (PlatformType)source->type : PLATFORM_TYPE_1,
+                .active = true};
         }
+        world.levelCursor++;
     }
-}
 
-void CheckGameOver()
-{
-    if (player.position.y > camera.target.y + (SCREEN_HEIGHT / 2.0f) + 50)
+    uint32_t cursorChunk = (uint32_t)world.levelCursor / level.header->chunkSize;
+    while (level.firstChunk < cursorChunk && level.chunks[level.firstChunk].topY > bottomLimit)
     {
-        gameState = GAME_OVER;
-        if (score > highScore)
-            highScore = score;
+        AdviseLevelChunk(level.firstChunk++, MADV_DONTNEED);
+    }
+
+    if (cursorChunk + 1 < level.header->chunkCount && level.prefetchedChunk != cursorChunk + 1)
+    {
+        level.prefetchedChunk = cursorChunk + 1;
+        AdviseLevelChunk(level.prefetchedChunk, MADV_WILLNEED);
     }
 }
 
-void DrawParallaxBackground(Texture2D texture, float parallaxFactor)
+static bool PlatformGeneratorHasWork(uint32_t epoch, float lastY)
 {
-    if (texture.id == 0)
-        return;
+    if (!__atomic_load_n(&generator.running, __ATOMIC_SEQ_CST) ||
+        __atomic_load_n(&generator.epoch, __ATOMIC_SEQ_CST) != epoch)
+        return true;
 
-    float cameraTopY = camera.target.y - SCREEN_HEIGHT / 2.0f;
-    float bgY_unwrapped = cameraTopY * parallaxFactor;
-    float offsetY = fmod(-bgY_unwrapped, texture.height);
-    if (offsetY > 0) offsetY -= texture.height;
+    if (generator.head - __atomic_load_n(&generator.tail, __ATOMIC_SEQ_CST) == GENERATOR_QUEUE_SIZE)
+        return false;
 
-    for (int y = (int)(offsetY - texture.height); y < SCREEN_HEIGHT; y += texture.height)
+    float horizonY;
+    __atomic_load(&generator.horizonY, &horizonY, __ATOMIC_SEQ_CST);
+    return lastY >= horizonY || __atomic_load_n(&generator.demand, __ATOMIC_SEQ_CST);
+}
+
+static void *PlatformGeneratorThread(void *arg)
+{
+    (void)arg;
+    uint32_t epoch = __atomic_load_n(&generator.epoch, __ATOMIC_ACQUIRE) - 1;
+    float lastX = 0.0f;
+    float lastY = 0.0f;
+    uint32_t seed = 0;
+
+    while (__atomic_load_n(&generator.running, __ATOMIC_ACQUIRE))
     {
-        
-        float bgX_unwrapped = camera.target.x * parallaxFactor;
-        float offsetX = fmod(-bgX_unwrapped, texture.width);
-        if (offsetX > 0) offsetX -= texture.width;
+        uint32_t currentEpoch = __atomic_load_n(&generator.epoch, __ATOMIC_ACQUIRE);
+        if (currentEpoch != epoch)
+        {
+            epoch = currentEpoch;
+            __atomic_load(&generator.resetX, &lastX, __ATOMIC_RELAXED);
+            __atomic_load(&generator.resetY, &lastY, __ATOMIC_RELAXED);
+            seed = __atomic_load_n(&generator.resetSeed, __ATOMIC_RELAXED);
+            __atomic_store(&generator.generatedY, &lastY, __ATOMIC_RELEASE);
+        }
 
-        for (int x = (int)(offsetX - texture.width); x < SCREEN_WIDTH; x += texture.width)
+        if (!PlatformGeneratorHasWork(epoch, lastY))
         {
-            DrawTexture(texture, x, y, WHITE);
-    
+            pthread_mutex_lock(&generator.lock);
+            __atomic_store_n(&generator.sleeping, true, __ATOMIC_SEQ_CST);
+            while (!PlatformGeneratorHasWork(epoch, lastY))
+                pthread_cond_wait(&generator.wake, &generator.lock);
+            __atomic_store_n(&generator.sleeping, false, __ATOMIC_SEQ_CST);
+            pthread_mutex_unlock(&generator.lock);
+            continue;
         }
+
+        uint32_t head = generator.head;
+        generator.items[head % GENERATOR_QUEUE_SIZE] = (GeneratedPlatform){NextPlatform(&lastX, &lastY, &seed), epoch};
+        __atomic_store_n(&generator.head, head + 1, __ATOMIC_RELEASE);
+        __atomic_store(&generator.generatedY, &lastY, __ATOMIC_RELEASE);
     }
+
+    return NULL;
 }
 
+static void WakePlatformGenerator()
+{
+    if (!__atomic_load_n(&generator.sleeping, __ATOMIC_SEQ_CST))
+        return;
 
-void DrawPlayer()
+    pthread_mutex_lock(&generator.lock);
+    pthread_cond_signal(&generator.wake);
+    pthread_mutex_unlock(&generator.lock);
+}
+
+bool StartPlatformGenerator()
 {
-    Animation *currentAnim = NULL;
+    generator.horizonY = INFINITY;
+    generator.running = true;
+    pthread_mutex_init(&generator.lock, NULL);
+    pthread_cond_init(&generator.wake, NULL);
 
-    switch (player.state)
+    if (pthread_create(&generator.thread, NULL, PlatformGeneratorThread, NULL) != 0)
     {
-    case IDLE:
-        currentAnim = &player.idleAnim;
-        break;
-    case WALKING:
-        currentAnim = &player.walkAnim;
-        break;
-    case JUMPING:
-        currentAnim = &player.jumpAnim;
-        break;
+        TraceLog(LOG_WARNING, "AVISO: thread de geracao nao iniciada, gerando no quadro");
+        generator.running = false;
+        pthread_cond_destroy(&generator.wake);
+        pthread_mutex_destroy(&generator.lock);
+        return false;
     }
+    return true;
+}
 
-    if (currentAnim->texture.id == 0)
-    {
-        DrawRectangleRec(player.hitbox,
-                         player.state == JUMPING ? RED : player.state == WALKING ? BLUE
-                                                                                : GREEN);
+void StopPlatformGenerator()
+{
+    if (!generator.running)
         return;
-    }
 
-    Rectangle src;
-    src.y = 0.0f;
-    src.height = (float)currentAnim->frameHeight;
+    pthread_mutex_lock(&generator.lock);
+    __atomic_store_n(&generator.running, false, __ATOMIC_SEQ_CST);
+    pthread_cond_signal(&generator.wake);
+    pthread_mutex_unlock(&generator.lock);
+    pthread_join(generator.thread, NULL);
+    pthread_cond_destroy(&generator.wake);
+    pthread_mutex_destroy(&generator.lock);
+}
 
-    if (player.facingRight)
-    {
-        src.x = (float)currentAnim->currentFrame * currentAnim->frameWidth;
-        src.width = (float)currentAnim->frameWidth;
-    }
-    else
+void ResetPlatformGenerator(float refX, float refY, uint32_t seed)
+{
+    for (int i = 0; i < GENERATOR_PREFILL; i++)
     {
-        src.x = (float)(currentAnim->currentFrame + 1) * currentAnim->frameWidth;
-        src.width = -(float)currentAnim->frameWidth;
+        generator.prefill[i] = NextPlatform(&refX, &refY, &seed);
     }
+    generator.prefillCursor = 0;
 
-    Rectangle dest = {
-        player.position.x,
-        player.position.y,
-        (float)currentAnim->frameWidth,
-        (float)currentAnim->frameHeight};
-
-    Vector2 origin = {
-        (float)currentAnim->frameWidth / 2.0f,
-        (float)currentAnim->frameHeight};
+    __atomic_store(&generator.resetX, &refX, __ATOMIC_RELAXED);
+    __atomic_store(&generator.resetY, &refY, __ATOMIC_RELAXED);
+    __atomic_store_n(&generator.resetSeed, seed, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&generator.epoch, 1, __ATOMIC_SEQ_CST);
+    WakePlatformGenerator();
+}
 
-    DrawTexturePro(currentAnim->texture, src, dest, origin, 0.0f, WHITE);
+static bool PlaceGeneratedPlatform(GameWorld *w, const LevelPlatform *source, float topLimit, float bottomLimit, int *slot)
+{
+    if (source->y < topLimit)
+        return false;
 
+    if (source->y <= bottomLimit)
+    {
+        while (*slot < MAX_PLATFORMS && w->platforms[*slot].active)
+            (*slot)++;
+        if (*slot == MAX_PLATFORMS)
+            return false;
+
+        w->platforms[*slot] = (Platform){
+            .rect = {source->x, source->y, source->width, PLATFORM_HEIGHT},
+            .type = (PlatformType)source->type,
+            .active = true};
+    }
+    return true;
 }
 
-void DrawPlatforms()
+void ConsumeGeneratedPlatforms(float topLimit, float bottomLimit)
 {
-    for (int i = 0; i < MAX_PLATFORMS; i++)
+    uint32_t epoch = __atomic_load_n(&generator.epoch, __ATOMIC_RELAXED);
+    uint32_t tail = generator.tail;
+    uint32_t head = __atomic_load_n(&generator.head, __ATOMIC_ACQUIRE);
+    int slot = 0;
+
+    while (tail != head && generator.items[tail % GENERATOR_QUEUE_SIZE].epoch != epoch)
+        tail++;
+
+    bool placing = true;
+    while (placing && generator.prefillCursor < GENERATOR_PREFILL)
     {
-        if (!platforms[i].active)
-            continue;
+        placing = PlaceGeneratedPlatform(&world, &generator.prefill[generator.prefillCursor], topLimit, bottomLimit, &slot);
+        if (placing)
+            generator.prefillCursor++;
+    }
 
-        if (platformTextures[platforms[i].type].id != 0)
+    while (placing)
+    {
+        if (head == tail)
         {
-            DrawTexturePro(
-                platformTextures[platforms[i].type],
-                (Rectangle){0, 0, (float)platformTextures[platforms[i].type].width, (float)platformTextures[platforms[i].type].height},
-                platforms[i].rect,
-                (Vector2){0, 0},
+            __atomic_store_n(&generator.tail, tail, __ATOMIC_SEQ_CST);
+            __atomic_store_n(&generator.demand, true, __ATOMIC_SEQ_CST);
+            WakePlatformGenerator();
+            while (head == tail)
+            {
+                sched_yield();
+                head = __atomic_load_n(&generator.head, __ATOMIC_ACQUIRE);
+            }
+            __atomic_store_n(&generator.demand, false, __ATOMIC_RELEASE);
+        }
+
+        const GeneratedPlatform *source = &generator.items[tail % GENERATOR_QUEUE_SIZE];
+        if (source->epoch == epoch && !PlaceGeneratedPlatform(&world, &source->platform, topLimit, bottomLimit, &slot))
+            break;
+        tail++;
+    }
+
+    if (tail != generator.tail)
+    {
+        __atomic_store_n(&generator.tail, tail, __ATOMIC_SEQ_CST);
+        WakePlatformGenerator();
+    }
+}
+
+void UpdateAnimation(Animation *anim, float deltaTime, bool reset)
+{
+    if (reset)
+    {
+        anim->currentFrame = 0;
+        anim->elapsedTime = 0.0f;
+        return;
+    }
+    anim->elapsedTime += deltaTime;
+    if (anim->elapsedTime >= anim->frameTime)
+    {
+        anim->currentFrame = (anim->currentFrame + 1) % anim->frames;
+        anim->elapsedTime = 0.0f;
+    }
+}
+
+
+bool StepPlayer(GameWorld *w, int moveX, bool jump, float dt)
+{
+    Player *player = &w->player;
+    player->previousHitbox = player->hitbox;
+    player->prevState = player->state;
+
+    if (moveX < 0)
+    {
+        player->velocity.x = -PLAYER_SPEED * w->gameSpeed;
+        player->facingRight = false;
+    }
+    else if (moveX > 0)
+    {
+        player->velocity.x = PLAYER_SPEED * w->gameSpeed;
+        player->facingRight = true;
+    }
+    else
+    {
+        player->velocity.x = 0;
+    }
+
+    bool jumped = jump && player->onGround;
+    if (jumped)
+    {
+        player->velocity.y = JUMP_FORCE;
+        player->onGround = false;
+        player->state = JUMPING;
+    }
+
+    player->velocity.y += GRAVITY * dt * w->gameSpeed;
+
+    if (player->velocity.y > MAX_FALL_SPEED)
+    {
+        player->velocity.y = MAX_FALL_SPEED;
+    }
+
+    player->position.x += player->velocity.x * dt;
+    player->position.y += player->velocity.y * dt;
+
+    player->hitbox.x = player->position.x - PLAYER_HITBOX_WIDTH / 2.0f;
+    player->hitbox.y = player->position.y - PLAYER_HITBOX_HEIGHT;
+
+    player->onGround = false;
+
+    if (player->velocity.y >= 0)
+    {
+        for (int i = 0; i < MAX_PLATFORMS; i++)
+        {
+            if (!w->platforms[i].active)
+                continue;
+
+            Rectangle playerFeetArea = {
+                player->hitbox.x,
+                player->hitbox.y + player->hitbox.height - 10,
+                player->hitbox.width,
+                15
+            };
+
+            Rectangle rect = w->platforms[i].rect;
+            if (playerFeetArea.x < rect.x + rect.width && playerFeetArea.x + playerFeetArea.width > rect.x &&
+                playerFeetArea.y < rect.y + rect.height && playerFeetArea.y + playerFeetArea.height > rect.y)
+            {
+                if (player->previousHitbox.y + player->previousHitbox.height <= w->platforms[i].rect.y + 1.0f)
+                {
+                    player->position.y = w->platforms[i].rect.y;
+                    player->velocity.y = 0;
+                    player->onGround = true;
+                    player->currentPlatform = i;
+                    break;
+                }
+            }
+        }
+    }
+
+    if (!player->onGround)
+    {
+        player->state = JUMPING;
+    }
+    else if (moveX != 0)
+    {
+        player->state = WALKING;
+    }
+    else
+    {
+        player->state = IDLE;
+    }
+
+    float heightDifference = w->startYPosition - (player->hitbox.y);
+    if (heightDifference > w->score)
+    {
+        w->score = (int)heightDifference;
+    }
+
+    w->gameSpeed = 1.0f + (w->score * 0.0005f);
+    if (w->gameSpeed > 2.5f)
+        w->gameSpeed = 2.5f;
+
+    return jumped;
+}
+
+void UpdatePlayer()
+{
+    if (input.jump && world.player.onGround)
+    {
+        Platform *current = &world.platforms[world.player.currentPlatform];
+        float refX = current->rect.x + current->rect.width / 2.0f;
+        float refY = current->rect.y;
+        GeneratePlatform(refX, refY);
+    }
+
+    float animationSpeed = world.gameSpeed;
+    StepPlayer(&world, input.moveX, input.jump, input.dt);
+
+    bool resetAnimation = (world.player.prevState != world.player.state);
+    switch (world.player.state)
+    {
+    case IDLE:
+        UpdateAnimation(&world.player.idleAnim, input.dt * animationSpeed, resetAnimation);
+        break;
+    case WALKING:
+        UpdateAnimation(&world.player.walkAnim, input.dt * animationSpeed, resetAnimation);
+        break;
+    case JUMPING:
+        UpdateAnimation(&world.player.jumpAnim, input.dt * animationSpeed, resetAnimation);
+        break;
+    }
+}
+
+void StartGame()
+{
+    if (session.recording)
+    {
+        session.checkpoint = CurrentCheckpoint();
+        session.newGamePending = true;
+    }
+
+    gameState = PLAYING;
+    InitPlatforms();
+    InitPlayer();
+    world.score = 0;
+    world.gameSpeed = 1.0f;
+    RewindReset();
+}
+
+static InputCheckpoint CurrentCheckpoint()
+{
+    if (!session.gameStarted)
+        return (InputCheckpoint){0};
+
+    return (InputCheckpoint){world.score, session.tick - session.gameStartTick,
+                             world.player.position.x, world.player.position.y};
+}
+
+static bool VerifyCheckpoint()
+{
+    InputCheckpoint expected;
+    InputCheckpoint actual = CurrentCheckpoint();
+    if (fread(&expected, sizeof(expected), 1, session.file) != 1)
+    {
+        TraceLog(LOG_WARNING, "AVISO: sessao sem verificacao no tick %u", session.tick);
+        session.diverged = true;
+        session.finished = true;
+        return false;
+    }
+
+    if (expected.score != actual.score || expected.ticks != actual.ticks ||
+        expected.x != actual.x || expected.y != actual.y)
+    {
+        TraceLog(LOG_WARNING, "AVISO: reproducao divergiu no tick %u (pontos %d/%d, ticks %u/%u, posicao %.2f,%.2f/%.2f,%.2f)",
+                 session.tick, expected.score, actual.score, expected.ticks, actual.ticks,
+                 expected.x, expected.y, actual.x, actual.y);
+        session.diverged = true;
+        session.finished = true;
+        return false;
+    }
+    return true;
+}
+
+bool StartInputRecording(const char *path, uint32_t seed)
+{
+    session.file = fopen(path, "wb");
+    if (session.file == NULL)
+    {
+        TraceLog(LOG_WARNING, "AVISO: nao foi possivel gravar %s", path);
+        return false;
+    }
+
+    InputHeader header = {.version = INPUT_VERSION, .seed = seed};
+    memcpy(header.magic, INPUT_MAGIC, 4);
+    fwrite(&header, sizeof(header), 1, session.file);
+
+    session.recording = true;
+    session.seed = seed;
+    session.tick = 0;
+    return true;
+}
+
+bool StartInputReplay(const char *path)
+{
+    session.file = fopen(path, "rb");
+    if (session.file == NULL)
+    {
+        TraceLog(LOG_WARNING, "AVISO: sessao %s nao encontrada", path);
+        return false;
+    }
+
+    InputHeader header;
+    if (fread(&header, sizeof(header), 1, session.file) != 1 ||
+        memcmp(header.magic, INPUT_MAGIC, 4) != 0 ||
+        header.version != INPUT_VERSION)
+    {
+        TraceLog(LOG_WARNING, "AVISO: sessao %s com formato invalido", path);
+        fclose(session.file);
+        session.file = NULL;
+        return false;
+    }
+
+    session.replaying = true;
+    session.seed = header.seed;
+    session.tick = 0;
+    session.tickCount = header.tickCount;
+    return true;
+}
+
+void StopInputSession()
+{
+    if (session.file == NULL)
+        return;
+
+    if (session.recording)
+    {
+        InputCheckpoint last = session.newGamePending ? session.checkpoint : CurrentCheckpoint();
+        fwrite(&last, sizeof(last), 1, session.file);
+
+        InputHeader header = {.version = INPUT_VERSION, .seed = session.seed, .tickCount = session.tick};
+        memcpy(header.magic, INPUT_MAGIC, 4);
+        fseek(session.file, 0, SEEK_SET);
+        fwrite(&header, sizeof(header), 1, session.file);
+    }
+
+    fclose(session.file);
+    session.file = NULL;
+    session.recording = false;
+    session.replaying = false;
+}
+
+void ReadInput()
+{
+    input = (InputFrame){0};
+
+    if (session.replaying)
+    {
+        unsigned char buttons;
+        if (session.tick >= session.tickCount)
+        {
+            VerifyCheckpoint();
+            session.finished = true;
+            return;
+        }
+        if (fread(&buttons, 1, 1, session.file) != 1 ||
+            fread(&input.dt, sizeof(input.dt), 1, session.file) != 1)
+        {
+            TraceLog(LOG_WARNING, "AVISO: sessao truncada no tick %u", session.tick);
+            session.diverged = true;
+            session.finished = true;
+            return;
+        }
+        input.moveX = (buttons & INPUT_LEFT) ? -1 : (buttons & INPUT_RIGHT) ? 1 : 0;
+        input.jump = (buttons & INPUT_JUMP) != 0;
+        input.rewind = (buttons & INPUT_REWIND) != 0;
+        input.rewindFast = (buttons & INPUT_REWIND_FAST) != 0;
+        input.newGame = (buttons & INPUT_NEW_GAME) != 0;
+        if (input.newGame)
+        {
+            if (!VerifyCheckpoint())
+                return;
+            session.gameStartTick = session.tick;
+            session.gameStarted = true;
+        }
+        session.tick++;
+        return;
+    }
+
+    if (session.scripted)
+    {
+        if (session.tick >= session.tickCount)
+        {
+            session.finished = true;
+            return;
+        }
+        ScriptedInput(0, session.tick, &input.moveX, &input.jump);
+        input.newGame = session.tick == 0 || gameState == GAME_OVER;
+        input.dt = 1.0f / 60.0f;
+        session.tick++;
+        return;
+    }
+
+    if (IsKeyDown(KEY_A) || IsKeyDown(KEY_LEFT))
+        input.moveX = -1;
+    else if (IsKeyDown(KEY_D) || IsKeyDown(KEY_RIGHT))
+        input.moveX = 1;
+    input.jump = IsKeyPressed(KEY_SPACE);
+    input.rewind = IsKeyDown(KEY_BACKSPACE);
+    input.rewindFast = IsKeyDown(KEY_LEFT_SHIFT);
+    input.dt = GetFrameTime();
+
+    if (session.recording && gameState != MENU)
+    {
+        unsigned char buttons = (input.moveX < 0 ? INPUT_LEFT : 0) |
+                                (input.moveX > 0 ? INPUT_RIGHT : 0) |
+                                (input.jump ? INPUT_JUMP : 0) |
+                                (input.rewind ? INPUT_REWIND : 0) |
+                                (input.rewindFast ? INPUT_REWIND_FAST : 0) |
+                                (session.newGamePending ? INPUT_NEW_GAME : 0);
+        fputc(buttons, session.file);
+        fwrite(&input.dt, sizeof(input.dt), 1, session.file);
+        if (session.newGamePending)
+        {
+            fwrite(&session.checkpoint, sizeof(session.checkpoint), 1, session.file);
+            session.gameStartTick = session.tick;
+            session.gameStarted = true;
+            session.newGamePending = false;
+        }
+        session.tick++;
+    }
+}
+
+static inline bool LaneAny(const LaneInt *mask)
+{
+    uint64_t words[sizeof(LaneInt) / sizeof(uint64_t)];
+    memcpy(words, mask, sizeof(words));
+
+    uint64_t any = 0;
+    for (size_t i = 0; i < sizeof(words) / sizeof(words[0]); i++)
+        any |= words[i];
+    return any != 0;
+}
+
+bool StepWorld(GameWorld *w, PlatformStream *stream, int moveX, bool jump, float dt)
+{
+    StepPlayer(w, moveX, jump, dt);
+    StepCamera(w);
+
+    float bottomLimit = EvictPlatforms(w);
+    float topLimit = w->camera.target.y - SCREEN_HEIGHT / 2.0f - PLATFORM_STREAM_AHEAD;
+    int slot = 0;
+    while (PlaceGeneratedPlatform(w, &stream->next, topLimit, bottomLimit, &slot))
+    {
+        stream->next = NextPlatform(&stream->lastX, &stream->lastY, &stream->seed);
+    }
+
+    return !PlayerFellOff(w);
+}
+
+void LoadWorldBatchLane(WorldBatch *batch, int lane, const GameWorld *w, const PlatformStream *stream)
+{
+    const Player *player = &w->player;
+    batch->positionX[lane] = player->position.x;
+    batch->positionY[lane] = player->position.y;
+    batch->velocityX[lane] = player->velocity.x;
+    batch->velocityY[lane] = player->velocity.y;
+    batch->hitboxX[lane] = player->hitbox.x;
+    batch->hitboxY[lane] = player->hitbox.y;
+    batch->previousHitboxX[lane] = player->previousHitbox.x;
+    batch->previousHitboxY[lane] = player->previousHitbox.y;
+    batch->gameSpeed[lane] = w->gameSpeed;
+    batch->startYPosition[lane] = w->startYPosition;
+    batch->onGround[lane] = player->onGround ? -1 : 0;
+    batch->facingRight[lane] = player->facingRight ? -1 : 0;
+    batch->state[lane] = player->state;
+    batch->previousState[lane] = player->prevState;
+    batch->currentPlatform[lane] = player->currentPlatform;
+    batch->score[lane] = w->score;
+    batch->cameraY[lane] = w->camera.target.y;
+    batch->alive[lane] = -1;
+
+    for (int i = 0; i < MAX_PLATFORMS; i++)
+    {
+        batch->platformX[i][lane] = w->platforms[i].rect.x;
+        batch->platformY[i][lane] = w->platforms[i].rect.y;
+        batch->platformWidth[i][lane] = w->platforms[i].rect.width;
+        batch->platformType[i][lane] = w->platforms[i].type;
+        batch->platformActive[i][lane] = w->platforms[i].active ? -1 : 0;
+    }
+
+    batch->streams[lane] = *stream;
+    batch->nextY[lane] = stream->next.y;
+}
+
+void StoreWorldBatchLane(const WorldBatch *batch, int lane, GameWorld *w, PlatformStream *stream)
+{
+    Player *player = &w->player;
+    player->previousHitbox.x = batch->previousHitboxX[lane];
+    player->previousHitbox.y = batch->previousHitboxY[lane];
+    player->prevState = (PlayerState)batch->previousState[lane];
+    player->position = (Vector2){batch->positionX[lane], batch->positionY[lane]};
+    player->velocity = (Vector2){batch->velocityX[lane], batch->velocityY[lane]};
+    player->hitbox.x = batch->hitboxX[lane];
+    player->hitbox.y = batch->hitboxY[lane];
+    player->onGround = batch->onGround[lane] != 0;
+    player->facingRight = batch->facingRight[lane] != 0;
+    player->state = (PlayerState)batch->state[lane];
+    player->currentPlatform = batch->currentPlatform[lane];
+    w->gameSpeed = batch->gameSpeed[lane];
+    w->score = batch->score[lane];
+    w->camera.target = (Vector2){batch->positionX[lane], batch->cameraY[lane]};
+    w->camera.offset = (Vector2){SCREEN_WIDTH / 2.0f, SCREEN_HEIGHT / 2.0f};
+
+    for (int i = 0; i < MAX_PLATFORMS; i++)
+    {
+        w->platforms[i] = (Platform){
+            .rect = {batch->platformX[i][lane], batch->platformY[i][lane], batch->platformWidth[i][lane], PLATFORM_HEIGHT},
+            .type = (PlatformType)batch->platformType[i][lane],
+            .active = batch->platformActive[i][lane] != 0};
+    }
+
+    *stream = batch->streams[lane];
+}
+
+static void RefillWorldBatchLane(WorldBatch *b, int lane, float topLimit, float bottomLimit)
+{
+    PlatformStream *stream = &b->streams[lane];
+    int slot = 0;
+
+    while (stream->next.y >= topLimit)
+    {
+        if (stream->next.y <= bottomLimit)
+        {
+            while (slot < MAX_PLATFORMS && b->platformActive[slot][lane])
+                slot++;
+            if (slot == MAX_PLATFORMS)
+                break;
+
+            b->platformX[slot][lane] = stream->next.x;
+            b->platformY[slot][lane] = stream->next.y;
+            b->platformWidth[slot][lane] = stream->next.width;
+            b->platformType[slot][lane] = stream->next.type;
+            b->platformActive[slot][lane] = -1;
+        }
+        stream->next = NextPlatform(&stream->lastX, &stream->lastY, &stream->seed);
+    }
+
+    b->nextY[lane] = stream->next.y;
+}
+
+void StepWorldBatch(WorldBatch *b, const LaneInt *moveX, const LaneInt *jump, float dt)
+{
+    const LaneFloat zero = {0};
+    const LaneInt none = {0};
+    LaneInt alive = b->alive;
+
+    LaneInt left = *moveX < 0;
+    LaneInt right = *moveX > 0;
+    LaneFloat speed = PLAYER_SPEED * b->gameSpeed;
+    LaneFloat velocityX = LANE_SELECT(left, -PLAYER_SPEED * b->gameSpeed, LANE_SELECT(right, speed, zero));
+    LaneInt facingRight = LANE_SELECT_INT(left, none, LANE_SELECT_INT(right, ~none, b->facingRight));
+
+    LaneInt jumped = *jump & b->onGround & alive;
+    LaneFloat velocityY = LANE_SELECT(jumped, zero + JUMP_FORCE, b->velocityY);
+
+    velocityY = velocityY + GRAVITY * dt * b->gameSpeed;
+    velocityY = LANE_SELECT(velocityY > MAX_FALL_SPEED, zero + MAX_FALL_SPEED, velocityY);
+
+    LaneFloat positionX = b->positionX + velocityX * dt;
+    LaneFloat positionY = b->positionY + velocityY * dt;
+
+    LaneFloat hitboxX = positionX - PLAYER_HITBOX_WIDTH / 2.0f;
+    LaneFloat hitboxY = positionY - PLAYER_HITBOX_HEIGHT;
+
+    LaneFloat feetTop = hitboxY + (float)PLAYER_HITBOX_HEIGHT - 10.0f;
+    LaneFloat feetBottom = feetTop + 15.0f;
+    LaneFloat feetRight = hitboxX + (float)PLAYER_HITBOX_WIDTH;
+    LaneFloat previousBottom = b->hitboxY + (float)PLAYER_HITBOX_HEIGHT;
+
+    LaneInt searching = velocityY >= 0.0f;
+    LaneInt onGround = none;
+    LaneInt currentPlatform = b->currentPlatform;
+
+    for (int i = 0; i < MAX_PLATFORMS; i++)
+    {
+        LaneFloat platformY = b->platformY[i];
+        LaneInt landed = searching & b->platformActive[i] &
+                         (hitboxX < b->platformX[i] + b->platformWidth[i]) &
+                         (feetRight > b->platformX[i]) &
+                         (feetTop < platformY + PLATFORM_HEIGHT) &
+                         (feetBottom > platformY) &
+                         (previousBottom <= platformY + 1.0f);
+
+        positionY = LANE_SELECT(landed, platformY, positionY);
+        velocityY = LANE_SELECT(landed, zero, velocityY);
+        currentPlatform = LANE_SELECT_INT(landed, none + i, currentPlatform);
+        onGround |= landed;
+        searching &= ~landed;
+    }
+
+    LaneInt state = LANE_SELECT_INT(onGround,
+                                    LANE_SELECT_INT(left | right, none + WALKING, none + IDLE),
+                                    none + JUMPING);
+
+    LaneFloat heightDifference = b->startYPosition - hitboxY;
+    LaneInt improved = heightDifference > __builtin_convertvector(b->score, LaneFloat);
+    LaneInt score = LANE_SELECT_INT(improved, __builtin_convertvector(heightDifference, LaneInt), b->score);
+
+    LaneFloat gameSpeed = 1.0f + __builtin_convertvector(score, LaneFloat) * 0.0005f;
+    gameSpeed = LANE_SELECT(gameSpeed > 2.5f, zero + 2.5f, gameSpeed);
+
+    LaneFloat cameraY = positionY - SCREEN_HEIGHT / 3.0f;
+    LaneFloat cameraLimit = b->startYPosition - SCREEN_HEIGHT / 2.0f + 50.0f;
+    cameraY = LANE_SELECT(cameraY > cameraLimit, cameraLimit, cameraY);
+
+    b->previousHitboxX = LANE_SELECT(alive, b->hitboxX, b->previousHitboxX);
+    b->previousHitboxY = LANE_SELECT(alive, b->hitboxY, b->previousHitboxY);
+    b->previousState = LANE_SELECT_INT(alive, b->state, b->previousState);
+    b->positionX = LANE_SELECT(alive, positionX, b->positionX);
+    b->positionY = LANE_SELECT(alive, positionY, b->positionY);
+    b->velocityX = LANE_SELECT(alive, velocityX, b->velocityX);
+    b->velocityY = LANE_SELECT(alive, velocityY, b->velocityY);
+    b->hitboxX = LANE_SELECT(alive, hitboxX, b->hitboxX);
+    b->hitboxY = LANE_SELECT(alive, hitboxY, b->hitboxY);
+    b->gameSpeed = LANE_SELECT(alive, gameSpeed, b->gameSpeed);
+    b->cameraY = LANE_SELECT(alive, cameraY, b->cameraY);
+    b->facingRight = LANE_SELECT_INT(alive, facingRight, b->facingRight);
+    b->onGround = LANE_SELECT_INT(alive, onGround, b->onGround);
+    b->state = LANE_SELECT_INT(alive, state, b->state);
+    b->currentPlatform = LANE_SELECT_INT(alive, currentPlatform, b->currentPlatform);
+    b->score = LANE_SELECT_INT(alive, score, b->score);
+    b->jumped = jumped;
+
+    LaneFloat bottomLimit = b->cameraY + SCREEN_HEIGHT / 2.0f + 100.0f;
+    for (int i = 0; i < MAX_PLATFORMS; i++)
+    {
+        b->platformActive[i] &= ~(alive & (b->platformY[i] > bottomLimit));
+    }
+
+    LaneFloat topLimit = b->cameraY - SCREEN_HEIGHT / 2.0f - PLATFORM_STREAM_AHEAD;
+    LaneInt refill = alive & (b->nextY >= topLimit);
+    if (LaneAny(&refill))
+    {
+        for (int lane = 0; lane < WORLD_LANES; lane++)
+        {
+            if (refill[lane])
+                RefillWorldBatchLane(b, lane, topLimit[lane], bottomLimit[lane]);
+        }
+    }
+
+    b->alive = alive & ~(b->positionY > b->cameraY + SCREEN_HEIGHT / 2.0f + 50.0f);
+}
+
+static void ScriptedInput(uint32_t worldIndex, uint32_t tick, int *moveX, bool *jump)
+{
+    uint32_t hold = (worldIndex * 2654435761u) ^ ((tick >> 5) * 2246822519u);
+    hold ^= hold >> 15;
+    *moveX = (int)(((hold >> 16) * 3) >> 16) - 1;
+
+    uint32_t press = (worldIndex * 3266489917u) ^ (tick * 668265263u);
+    press ^= press >> 13;
+    *jump = (((press >> 16) * 24) >> 16) == 0;
+}
+
+static void ScriptedInputBatch(const LaneUInt *worldIndex, const LaneUInt *tick, LaneInt *moveX, LaneInt *jump)
+{
+    LaneUInt hold = (*worldIndex * 2654435761u) ^ ((*tick >> 5) * 2246822519u);
+    hold ^= hold >> 15;
+    *moveX = (LaneInt)(((hold >> 16) * 3) >> 16) - 1;
+
+    LaneUInt press = (*worldIndex * 3266489917u) ^ (*tick * 668265263u);
+    press ^= press >> 13;
+    *jump = (((press >> 16) * 24) >> 16) == 0;
+}
+
+static double ElapsedSeconds(struct timespec start, struct timespec end)
+{
+    return (double)(end.tv_sec - start.tv_sec) + (double)(end.tv_nsec - start.tv_nsec) / 1e9;
+}
+
+static int NextBatchWorld(WorldBatch *b, int lane, int *nextWorld, int worldCount,
+                          const GameWorld *worlds, const PlatformStream *streams)
+{
+    if (*nextWorld >= worldCount)
+    {
+        b->alive[lane] = 0;
+        return -1;
+    }
+
+    LoadWorldBatchLane(b, lane, &worlds[*nextWorld], &streams[*nextWorld]);
+    return (*nextWorld)++;
+}
+
+int RunBatchEvaluation(int worldCount, int ticks)
+{
+    if (worldCount <= 0 || ticks <= 0)
+        return 1;
+
+    const float dt = 1.0f / 60.0f;
+
+    GameWorld *worlds = malloc((size_t)worldCount * sizeof(GameWorld));
+    GameWorld *reference = malloc((size_t)worldCount * sizeof(GameWorld));
+    PlatformStream *streams = malloc((size_t)worldCount * sizeof(PlatformStream));
+    PlatformStream *referenceStreams = malloc((size_t)worldCount * sizeof(PlatformStream));
+    int *lifetimes = malloc((size_t)worldCount * sizeof(int));
+    int *referenceLifetimes = malloc((size_t)worldCount * sizeof(int));
+    WorldBatch *batch = NULL;
+    if (posix_memalign((void **)&batch, sizeof(LaneInt), sizeof(WorldBatch)) != 0)
+        batch = NULL;
+    if (worlds == NULL || reference == NULL || streams == NULL || referenceStreams == NULL ||
+        lifetimes == NULL || referenceLifetimes == NULL || batch == NULL)
+    {
+        free(worlds);
+        free(reference);
+        free(streams);
+        free(referenceStreams);
+        free(lifetimes);
+        free(referenceLifetimes);
+        free(batch);
+        return 1;
+    }
+
+    for (int i = 0; i < worldCount; i++)
+    {
+        InitPlatforms();
+        InitPlayer();
+        world.gameSpeed = 1.0f;
+
+        Rectangle top = world.platforms[7].rect;
+        PlatformStream stream = {.lastX = top.x + top.width / 2.0f, .lastY = top.y, .seed = world.generatorSeed};
+        stream.next = NextPlatform(&stream.lastX, &stream.lastY, &stream.seed);
+
+        worlds[i] = world;
+        reference[i] = world;
+        streams[i] = stream;
+        referenceStreams[i] = stream;
+    }
+
+    struct timespec start, end;
+    long long steps = 0;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < worldCount; i++)
+    {
+        int t = 0;
+        bool alive = true;
+        while (alive && t < ticks)
+        {
+            int moveX;
+            bool jump;
+            ScriptedInput((uint32_t)i, (uint32_t)t, &moveX, &jump);
+            alive = StepWorld(&reference[i], &referenceStreams[i], moveX, jump, dt);
+            t++;
+        }
+        referenceLifetimes[i] = alive ? t : -t;
+        steps += t;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double scalarTime = ElapsedSeconds(start, end);
+
+    int laneWorld[WORLD_LANES];
+    int nextWorld = 0;
+    LaneUInt worldIndex = {0};
+    LaneUInt tick = {0};
+    LaneInt jumpCount = {0};
+    const LaneInt none = {0};
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int lane = 0; lane < WORLD_LANES; lane++)
+    {
+        laneWorld[lane] = NextBatchWorld(batch, lane, &nextWorld, worldCount, worlds, streams);
+        worldIndex[lane] = (uint32_t)laneWorld[lane];
+    }
+    while (LaneAny(&batch->alive))
+    {
+        LaneInt moveX;
+        LaneInt jump;
+        ScriptedInputBatch(&worldIndex, &tick, &moveX, &jump);
+        StepWorldBatch(batch, &moveX, &jump, dt);
+        jumpCount -= batch->jumped;
+        tick += 1;
+
+        LaneInt occupied = (LaneInt)worldIndex != (none - 1);
+        LaneInt finished = occupied & (~batch->alive | ((LaneInt)tick >= ticks));
+        if (!LaneAny(&finished))
+            continue;
+
+        for (int lane = 0; lane < WORLD_LANES; lane++)
+        {
+            if (!finished[lane])
+                continue;
+
+            int i = laneWorld[lane];
+            StoreWorldBatchLane(batch, lane, &worlds[i], &streams[i]);
+            lifetimes[i] = batch->alive[lane] ? (int)tick[lane] : -(int)tick[lane];
+
+            laneWorld[lane] = NextBatchWorld(batch, lane, &nextWorld, worldCount, worlds, streams);
+            worldIndex[lane] = (uint32_t)laneWorld[lane];
+            tick[lane] = 0;
+        }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double batchTime = ElapsedSeconds(start, end);
+
+    int mismatches = 0;
+    int survivors = 0;
+    long long jumpsTaken = 0;
+    long long bestScore = 0;
+    long long totalScore = 0;
+    for (int lane = 0; lane < WORLD_LANES; lane++)
+    {
+        jumpsTaken += jumpCount[lane];
+    }
+
+    for (int i = 0; i < worldCount; i++)
+    {
+        const GameWorld *a = &worlds[i];
+        const GameWorld *r = &reference[i];
+        bool same = lifetimes[i] == referenceLifetimes[i] &&
+                    memcmp(&a->player.hitbox, &r->player.hitbox, sizeof(Rectangle)) == 0 &&
+                    memcmp(&a->player.previousHitbox, &r->player.previousHitbox, sizeof(Rectangle)) == 0 &&
+                    memcmp(&a->player.position, &r->player.position, sizeof(Vector2)) == 0 &&
+                    memcmp(&a->player.velocity, &r->player.velocity, sizeof(Vector2)) == 0 &&
+                    memcmp(&a->gameSpeed, &r->gameSpeed, sizeof(float)) == 0 &&
+                    memcmp(&a->camera.target, &r->camera.target, sizeof(Vector2)) == 0 &&
+                    a->player.onGround == r->player.onGround &&
+                    a->player.facingRight == r->player.facingRight &&
+                    a->player.state == r->player.state &&
+                    a->player.prevState == r->player.prevState &&
+                    a->player.currentPlatform == r->player.currentPlatform &&
+                    a->score == r->score &&
+                    streams[i].seed == referenceStreams[i].seed &&
+                    memcmp(&streams[i].next, &referenceStreams[i].next, sizeof(LevelPlatform)) == 0;
+        for (int p = 0; same && p < MAX_PLATFORMS; p++)
+        {
+            same = a->platforms[p].active == r->platforms[p].active &&
+                   (!a->platforms[p].active ||
+                    (memcmp(&a->platforms[p].rect, &r->platforms[p].rect, sizeof(Rectangle)) == 0 &&
+                     a->platforms[p].type == r->platforms[p].type));
+        }
+        if (!same)
+            mismatches++;
+
+        survivors += lifetimes[i] > 0;
+        totalScore += a->score;
+        if (a->score > bestScore)
+            bestScore = a->score;
+    }
+
+    printf("Mundos: %d (%d por lote), ticks: %d, executados: %lld\n", worldCount, WORLD_LANES, ticks, steps);
+    printf("Escalar: %.1f M mundo-ticks/s\n", steps / scalarTime / 1e6);
+    printf("Lotes:   %.1f M mundo-ticks/s (%.1fx)\n", steps / batchTime / 1e6, scalarTime / batchTime);
+    printf("Pulos: %lld, melhor pontuacao: %lld, media: %.1f, vivos: %d, divergencias: %d\n",
+           jumpsTaken, bestScore, (double)totalScore / worldCount, survivors, mismatches);
+
+    free(worlds);
+    free(reference);
+    free(streams);
+    free(referenceStreams);
+    free(lifetimes);
+    free(referenceLifetimes);
+    free(batch);
+    return mismatches == 0 ? 0 : 1;
+}
+
+void StepCamera(GameWorld *w)
+{
+    
+    w->camera.target.x = w->player.position.x;
+    w->camera.target.y = w->player.position.y - SCREEN_HEIGHT / 3.0f; 
+
+    if (w->camera.target.y > w->startYPosition - SCREEN_HEIGHT / 2.0f + 50)
+    {
+        w->camera.target.y = w->startYPosition - SCREEN_HEIGHT / 2.0f + 50;
+    }
+
+    w->camera.offset = (Vector2){SCREEN_WIDTH / 2.0f, SCREEN_HEIGHT / 2.0f};
+}
+
+void UpdateGameCamera()
+{
+    StepCamera(&world);
+}
+
+float EvictPlatforms(GameWorld *w)
+{
+    float bottomLimit = w->camera.target.y + SCREEN_HEIGHT / 2.0f + 100;
+    for (int i = 0; i < MAX_PLATFORMS; i++)
+    {
+        if (w->platforms[i].active && w->platforms[i].rect.y > bottomLimit)
+        {
+            w->platforms[i].active = false;
+        }
+    }
+    return bottomLimit;
+}
+
+bool PlayerFellOff(const GameWorld *w)
+{
+    return w->player.position.y > w->camera.target.y + (SCREEN_HEIGHT / 2.0f) + 50;
+}
+
+void UpdatePlatforms()
+{
+    float bottomLimit = EvictPlatforms(&world);
+
+    if (level.map != NULL)
+    {
+        StreamLevel(world.camera.target.y - SCREEN_HEIGHT / 2.0f - PLATFORM_STREAM_AHEAD, bottomLimit);
+        return;
+    }
+
+    if (generator.running)
+    {
+        float horizonY = world.camera.target.y - SCREEN_HEIGHT / 2.0f - GENERATOR_LOOKAHEAD;
+        __atomic_store(&generator.horizonY, &horizonY, __ATOMIC_SEQ_CST);
+        if (__atomic_load_n(&generator.sleeping, __ATOMIC_SEQ_CST))
+        {
+            float generatedY;
+            __atomic_load(&generator.generatedY, &generatedY, __ATOMIC_ACQUIRE);
+            if (generatedY >= horizonY)
+                WakePlatformGenerator();
+        }
+        ConsumeGeneratedPlatforms(world.camera.target.y - SCREEN_HEIGHT / 2.0f - PLATFORM_STREAM_AHEAD, bottomLimit);
+        return;
+    }
+
+    float highestActivePlatformY = -INFINITY;
+    for (int i = 0; i < MAX_PLATFORMS; i++)
+    {
+        if (world.platforms[i].active)
+        {
+            if (world.platforms[i].rect.y < highestActivePlatformY || highestActivePlatformY == -INFINITY)
+            {
+                highestActivePlatformY = world.platforms[i].rect.y;
+            }
+        }
+    }
+
+    if (highestActivePlatformY == -INFINITY || highestActivePlatformY > world.camera.target.y - SCREEN_HEIGHT / 2.0f + 150)
+    {
+        float refX = SCREEN_WIDTH / 2.0f;
+        if (highestActivePlatformY != -INFINITY)
+        {
+            for (int i = 0; i < MAX_PLATFORMS; i++)
+            {
+                if (world.platforms[i].active && world.platforms[i].rect.y == highestActivePlatformY)
+                {
+                    refX = world.platforms[i].rect.x + world.platforms[i].rect.width / 2.0f;
+                    break;
+                }
+            }
+        }
+        else
+        {
+            highestActivePlatformY = world.camera.target.y - SCREEN_HEIGHT / 2.0f;
+        }
+
+        for (int j = 0; j < 5; j++)
+        {
+            GeneratePlatform(refX, highestActivePlatformY - (j * (PLATFORM_MAX_GAP + PLATFORM_HEIGHT)));
+        }
+    }
+}
+
+void CheckGameOver()
+{
+    if (PlayerFellOff(&world))
+    {
+        gameState = GAME_OVER;
+        if (world.score > highScore)
+            highScore = world.score;
+    }
+}
+
+static RewindSegment *RewindSegmentAt(int index)
+{
+    return &rewindBuffer.segments[(rewindBuffer.oldest + index) % REWIND_SEGMENTS];
+}
+
+static int RewindEncodeDelta(const GameWorld *from, const GameWorld *to, unsigned char *out)
+{
+    const unsigned char *a = (const unsigned char *)from;
+    const unsigned char *b = (const unsigned char *)to;
+    unsigned char *p = out;
+    size_t i = 0;
+
+    while (i < REWIND_WORLD_WORDS)
+    {
+        int skip = 0;
+        while (i < REWIND_WORLD_WORDS && skip < 255 && memcmp(a + i * 4, b + i * 4, 4) == 0)
+        {
+            i++;
+            skip++;
+        }
+        if (i == REWIND_WORLD_WORDS)
+            break;
+
+        unsigned char *header = p;
+        p += 2;
+        int count = 0;
+        while (i < REWIND_WORLD_WORDS && count < 255 && memcmp(a + i * 4, b + i * 4, 4) != 0)
+        {
+            uint32_t wa, wb;
+            memcpy(&wa, a + i * 4, 4);
+            memcpy(&wb, b + i * 4, 4);
+            wa ^= wb;
+            memcpy(p, &wa, 4);
+            p += 4;
+            i++;
+            count++;
+        }
+        header[0] = (unsigned char)skip;
+        header[1] = (unsigned char)count;
+    }
+
+    return (int)(p - out);
+}
+
+static void RewindApplyDelta(GameWorld *target, const unsigned char *p, const unsigned char *end)
+{
+    unsigned char *w = (unsigned char *)target;
+    size_t i = 0;
+
+    while (p < end)
+    {
+        i += p[0];
+        int count = p[1];
+        p += 2;
+        for (int c = 0; c < count; c++, i++, p += 4)
+        {
+            uint32_t ww, x;
+            memcpy(&ww, w + i * 4, 4);
+            memcpy(&x, p, 4);
+            ww ^= x;
+            memcpy(w + i * 4, &ww, 4);
+        }
+    }
+}
+
+static void RewindApplySegmentDelta(RewindSegment *seg, int tick)
+{
+    int end = (tick + 1 < seg->ticks) ? seg->deltaOffset[tick + 1] : seg->used;
+    RewindApplyDelta(&world, seg->deltas + seg->deltaOffset[tick], seg->deltas + end);
+}
+
+void RewindReset()
+{
+    rewindBuffer.oldest = 0;
+    rewindBuffer.count = 0;
+    rewindBuffer.rewinding = false;
+    RewindRecord();
+}
+
+void RewindRecord()
+{
+    RewindSegment *seg = rewindBuffer.count > 0 ? RewindSegmentAt(rewindBuffer.count - 1) : NULL;
+
+    if (seg == NULL || seg->ticks >= REWIND_KEYFRAME_INTERVAL ||
+        seg->used + (int)REWIND_MAX_DELTA_BYTES > REWIND_SEGMENT_BYTES)
+    {
+        if (rewindBuffer.count == REWIND_SEGMENTS)
+        {
+            rewindBuffer.oldest = (rewindBuffer.oldest + 1) % REWIND_SEGMENTS;
+            rewindBuffer.count--;
+        }
+        seg = RewindSegmentAt(rewindBuffer.count++);
+        seg->keyframe = world;
+        seg->ticks = 0;
+        seg->used = 0;
+    }
+    else
+    {
+        seg->deltaOffset[seg->ticks++] = (uint16_t)seg->used;
+        seg->used += RewindEncodeDelta(&rewindBuffer.last, &world, seg->deltas + seg->used);
+    }
+
+    rewindBuffer.last = world;
+}
+
+void RewindStepBack()
+{
+    RewindSegment *seg = RewindSegmentAt(rewindBuffer.cursorSegment);
+
+    if (rewindBuffer.cursorTick > 0)
+    {
+        RewindApplySegmentDelta(seg, --rewindBuffer.cursorTick);
+    }
+    else if (rewindBuffer.cursorSegment > 0)
+    {
+        seg = RewindSegmentAt(--rewindBuffer.cursorSegment);
+        world = seg->keyframe;
+        for (int t = 0; t < seg->ticks; t++)
+        {
+            RewindApplySegmentDelta(seg, t);
+        }
+        rewindBuffer.cursorTick = seg->ticks;
+    }
+}
+
+void RewindStepForward()
+{
+    RewindSegment *seg = RewindSegmentAt(rewindBuffer.cursorSegment);
+
+    if (rewindBuffer.cursorTick < seg->ticks)
+    {
+        RewindApplySegmentDelta(seg, rewindBuffer.cursorTick++);
+    }
+    else if (rewindBuffer.cursorSegment < rewindBuffer.count - 1)
+    {
+        seg = RewindSegmentAt(++rewindBuffer.cursorSegment);
+        world = seg->keyframe;
+        rewindBuffer.cursorTick = 0;
+    }
+}
+
+void RewindResume()
+{
+    RewindSegment *seg = RewindSegmentAt(rewindBuffer.cursorSegment);
+
+    if (rewindBuffer.cursorTick < seg->ticks)
+    {
+        seg->used = seg->deltaOffset[rewindBuffer.cursorTick];
+        seg->ticks = rewindBuffer.cursorTick;
+    }
+    rewindBuffer.count = rewindBuffer.cursorSegment + 1;
+    rewindBuffer.last = world;
+    rewindBuffer.rewinding = false;
+
+    int highest = -1;
+    for (int i = 0; i < MAX_PLATFORMS; i++)
+    {
+        if (world.platforms[i].active && (highest < 0 || world.platforms[i].rect.y < world.platforms[highest].rect.y))
+            highest = i;
+    }
+    if (highest >= 0)
+    {
+        Rectangle rect = world.platforms[highest].rect;
+        world.generatorSeed = world.generatorSeed * 1664525u + 1013904223u;
+        ResetPlatformGenerator(rect.x + rect.width / 2.0f, rect.y, world.generatorSeed);
+    }
+}
+
+bool UpdateRewind()
+{
+    if (!input.rewind || rewindBuffer.count == 0)
+    {
+        if (rewindBuffer.rewinding)
+            RewindResume();
+        return false;
+    }
+
+    if (!rewindBuffer.rewinding)
+    {
+        rewindBuffer.rewinding = true;
+        rewindBuffer.cursorSegment = rewindBuffer.count - 1;
+        rewindBuffer.cursorTick = RewindSegmentAt(rewindBuffer.cursorSegment)->ticks;
+        world = rewindBuffer.last;
+    }
+
+    int steps = input.rewindFast ? REWIND_SCRUB_FAST : 1;
+    bool forward = input.moveX > 0;
+    for (int i = 0; i < steps; i++)
+    {
+        if (forward)
+            RewindStepForward();
+        else
+            RewindStepBack();
+    }
+
+    return true;
+}
+
+void DrawParallaxBackground(Texture2D texture, float parallaxFactor)
+{
+    if (texture.id == 0)
+        return;
+
+    float cameraTopY = world.camera.target.y - SCREEN_HEIGHT / 2.0f;
+    float bgY_unwrapped = cameraTopY * parallaxFactor;
+    float offsetY = fmod(-bgY_unwrapped, texture.height);
+    if (offsetY > 0) offsetY -= texture.height;
+
+    for (int y = (int)(offsetY - texture.height); y < SCREEN_HEIGHT; y += texture.height)
+    {
+        
+        float bgX_unwrapped = world.camera.target.x * parallaxFactor;
+        float offsetX = fmod(-bgX_unwrapped, texture.width);
+        if (offsetX > 0) offsetX -= texture.width;
+
+        for (int x = (int)(offsetX - texture.width); x < SCREEN_WIDTH; x += texture.width)
+        {
+            DrawTexture(texture, x, y, WHITE);
+    
+        }
+    }
+}
+
+
+void DrawPlayer()
+{
+    Animation *currentAnim = NULL;
+
+    switch (world.player.state)
+    {
+    case IDLE:
+        currentAnim = &world.player.idleAnim;
+        break;
+    case WALKING:
+        currentAnim = &world.player.walkAnim;
+        break;
+    case JUMPING:
+        currentAnim = &world.player.jumpAnim;
+        break;
+    }
+
+    if (currentAnim->texture.id == 0)
+    {
+        DrawRectangleRec(world.player.hitbox,
+                         world.player.state == JUMPING ? RED : world.player.state == WALKING ? BLUE
+                                                                                : GREEN);
+        return;
+    }
+
+    Rectangle src;
+    src.y = 0.0f;
+    src.height = (float)currentAnim->frameHeight;
+
+    if (world.player.facingRight)
+    {
+        src.x = (float)currentAnim->currentFrame * currentAnim->frameWidth;
+        src.width = (float)currentAnim->frameWidth;
+    }
+    else
+    {
+        src.x = (float)(currentAnim->currentFrame + 1) * currentAnim->frameWidth;
+        src.width = -(float)currentAnim->frameWidth;
+    }
+
+    Rectangle dest = {
+        world.player.position.x,
+        world.player.position.y,
+        (float)currentAnim->frameWidth,
+        (float)currentAnim->frameHeight};
+
+    Vector2 origin = {
+        (float)currentAnim->frameWidth / 2.0f,
+        (float)currentAnim->frameHeight};
+
+    DrawTexturePro(currentAnim->texture, src, dest, origin, 0.0f, WHITE);
+
+}
+
+void DrawPlatforms()
+{
+    for (int i = 0; i < MAX_PLATFORMS; i++)
+    {
+        if (!world.platforms[i].active)
+            continue;
+
+        if (platformTextures[world.platforms[i].type].id != 0)
+        {
+            DrawTexturePro(
+                platformTextures[world.platforms[i].type],
+                (Rectangle){0, 0, (float)platformTextures[world.platforms[i].type].width, (float)platformTextures[world.platforms[i].type].height},
+                world.platforms[i].rect,
+                (Vector2){0, 0},
                 0.0f,
                 WHITE);
         }
         else
         {
             Color colors[] = {BROWN, DARKBROWN, BEIGE};
-            DrawRectangleRec(platforms[i].rect, colors[platforms[i].type]);
+            DrawRectangleRec(world.platforms[i].rect, colors[world.platforms[i].type]);
         }
     }
 }
@@ -668,11 +2309,7 @@ void DrawMenu()
         Vector2 mousePos = GetMousePosition();
         if (CheckCollisionPointRec(mousePos, btnRect))
         {
-            gameState = PLAYING;
-            InitPlatforms();
-            InitPlayer();
-            score = 0;
-            gameSpeed = 1.0f;
+            StartGame();
         }
     }
 
@@ -686,10 +2323,13 @@ void DrawMenu()
              SCREEN_WIDTH / 2 - 180, SCREEN_HEIGHT - 50, 20, WHITE);
 }
 
-void DrawGameOver()
+void DrawGameOverOverlay(int width, int height)
 {
-    DrawRectangle(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT, Fade(BLACK, 0.7f));
+    DrawRectangle(0, 0, width, height, Fade(BLACK, 0.7f));
+}
 
+void DrawGameOver()
+{
     if (gameOverTexture.id != 0)
     {
         float scale = 0.7f;
@@ -703,7 +2343,7 @@ void DrawGameOver()
         DrawText("CAIU E PERDEU!", SCREEN_WIDTH / 2 - 150, SCREEN_HEIGHT / 2 - 80, 40, RED);
     }
 
-    DrawText(TextFormat("Plataformas: %d", score), SCREEN_WIDTH / 2 - 100, SCREEN_HEIGHT / 2 - 20, 30, WHITE);
+    DrawText(TextFormat("Plataformas: %d", world.score), SCREEN_WIDTH / 2 - 100, SCREEN_HEIGHT / 2 - 20, 30, WHITE);
 
     if (highScore > 0)
     {
@@ -715,47 +2355,358 @@ void DrawGameOver()
 
 void DrawHUD()
 {
-    DrawText(TextFormat("Plataformas: %d", score), 10, 10, 20, WHITE);
-    DrawText(TextFormat("Velocidade: %.1fx", gameSpeed), 10, 35, 16, GREEN);
+    DrawText(TextFormat("Plataformas: %d", world.score), 10, 10, 20, WHITE);
+    DrawText(TextFormat("Velocidade: %.1fx", world.gameSpeed), 10, 35, 16, GREEN);
     DrawText("ESC: Menu", SCREEN_WIDTH - 100, 10, 20, LIGHTGRAY);
+    DrawText("BACKSPACE: Voltar", SCREEN_WIDTH - 150, 35, 16, LIGHTGRAY);
+
+    if (rewindBuffer.rewinding)
+    {
+        DrawText("<< REBOBINANDO", SCREEN_WIDTH / 2 - 90, 10, 20, YELLOW);
+    }
+
+    if (renderScaler.divisor > 1)
+    {
+        DrawText(TextFormat("Resolucao: %dx%d%s", SCREEN_WIDTH / renderScaler.divisor, SCREEN_HEIGHT / renderScaler.divisor,
+                            renderScaler.autoScale ? " (auto)" : ""),
+                 10, 55, 16, LIGHTGRAY);
+    }
+}
+
+void DrawWorld(Camera2D view)
+{
+    BeginMode2D(view);
+    DrawParallaxBackground(gameBackgroundTexture, 0.2f);
+    DrawPlatforms();
+    DrawPlayer();
+    EndMode2D();
 }
 
-int main()
+void DrawInterface()
 {
+    if (gameState == GAME_OVER)
+        DrawGameOver();
+    else
+        DrawHUD();
+}
+
+void SetRenderDivisor(int divisor)
+{
+    if (divisor == renderScaler.divisor)
+        return;
+
+    if (renderScaler.target.id != 0)
+    {
+        UnloadRenderTexture(renderScaler.target);
+        renderScaler.target = (RenderTexture2D){0};
+    }
+
+    if (divisor > 1)
+    {
+        renderScaler.target = LoadRenderTexture(SCREEN_WIDTH / divisor, SCREEN_HEIGHT / divisor);
+        if (renderScaler.target.id == 0)
+        {
+            TraceLog(LOG_WARNING, "AVISO: alvo de renderizacao %dx%d nao criado", SCREEN_WIDTH / divisor, SCREEN_HEIGHT / divisor);
+            divisor = 1;
+        }
+        else
+        {
+            SetTextureFilter(renderScaler.target.texture, TEXTURE_FILTER_POINT);
+        }
+    }
+
+    renderScaler.divisor = divisor;
+    renderScaler.stableTime = 0.0f;
+    renderScaler.overBudgetTime = 0.0f;
+    renderScaler.cooldown = 1.0f;
+}
+
+void UpdateRenderScale()
+{
+    if (IsKeyPressed(KEY_F1))
+    {
+        renderScaler.autoScale = false;
+        SetRenderDivisor(renderScaler.divisor >= RENDER_SCALE_MAX ? 1 : renderScaler.divisor * 2);
+    }
+    if (IsKeyPressed(KEY_F2))
+    {
+        renderScaler.autoScale = !renderScaler.autoScale;
+        renderScaler.upgradeDelay = RENDER_UPGRADE_DELAY;
+    }
+    if (IsKeyPressed(KEY_F3))
+    {
+        renderScaler.hudNative = !renderScaler.hudNative;
+    }
+
+    if (!renderScaler.autoScale || gameState == MENU)
+        return;
+
+    float frameTime = fminf(GetFrameTime(), RENDER_FRAME_BUDGET * 2.0f);
+    renderScaler.averageUpdateTime += (fminf(renderScaler.updateTime, RENDER_FRAME_BUDGET * 2.0f) - renderScaler.averageUpdateTime) * 0.05f;
+    renderScaler.averageDrawTime += (fminf(renderScaler.drawTime, RENDER_FRAME_BUDGET * 2.0f) - renderScaler.averageDrawTime) * 0.05f;
+    float workTime = renderScaler.averageUpdateTime + renderScaler.averageDrawTime;
+    float finerWorkTime = renderScaler.averageUpdateTime + renderScaler.averageDrawTime * 4.0f;
+
+    if (renderScaler.cooldown > 0.0f)
+    {
+        renderScaler.cooldown -= frameTime;
+        return;
+    }
+
+    if (workTime > RENDER_WORK_BUDGET)
+    {
+        renderScaler.overBudgetTime += frameTime;
+        if (renderScaler.overBudgetTime >= RENDER_DOWNGRADE_DELAY && renderScaler.divisor < RENDER_SCALE_MAX)
+        {
+            SetRenderDivisor(renderScaler.divisor * 2);
+            renderScaler.upgradeDelay = fminf(renderScaler.upgradeDelay * 2.0f, RENDER_UPGRADE_DELAY_MAX);
+        }
+        renderScaler.stableTime = 0.0f;
+    }
+    else if (renderScaler.divisor > 1 && finerWorkTime < RENDER_WORK_BUDGET)
+    {
+        renderScaler.overBudgetTime = 0.0f;
+        renderScaler.stableTime += frameTime;
+        if (renderScaler.stableTime > renderScaler.upgradeDelay)
+            SetRenderDivisor(renderScaler.divisor / 2);
+    }
+    else
+    {
+        renderScaler.overBudgetTime = 0.0f;
+        renderScaler.stableTime = 0.0f;
+    }
+}
+
+void RenderLowResolutionWorld()
+{
+    int divisor = renderScaler.divisor;
+    Camera2D view = world.camera;
+    view.offset.x /= divisor;
+    view.offset.y /= divisor;
+    view.zoom /= divisor;
+
+    BeginTextureMode(renderScaler.target);
+    ClearBackground(SKYBLUE);
+    DrawWorld(view);
+
+    if (gameState == GAME_OVER)
+        DrawGameOverOverlay(renderScaler.target.texture.width, renderScaler.target.texture.height);
+
+    if (!renderScaler.hudNative)
+    {
+        BeginMode2D((Camera2D){.zoom = 1.0f / divisor});
+        DrawInterface();
+        EndMode2D();
+    }
+    EndTextureMode();
+}
+
+void DrawGameplay()
+{
+    if (renderScaler.divisor == 1)
+    {
+        DrawWorld(world.camera);
+        if (gameState == GAME_OVER)
+            DrawGameOverOverlay(SCREEN_WIDTH, SCREEN_HEIGHT);
+        DrawInterface();
+        return;
+    }
+
+    Texture2D texture = renderScaler.target.texture;
+    DrawTexturePro(texture,
+                   (Rectangle){0, 0, (float)texture.width, -(float)texture.height},
+                   (Rectangle){0, 0, (float)SCREEN_WIDTH, (float)SCREEN_HEIGHT},
+                   (Vector2){0, 0},
+                   0.0f,
+                   WHITE);
+
+    if (renderScaler.hudNative)
+        DrawInterface();
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc >= 2 && strcmp(argv[1], "--gerar-nivel") == 0)
+    {
+        if (argc < 4)
+        {
+            TraceLog(LOG_WARNING, "AVISO: uso: --gerar-nivel <arquivo> <plataformas> [semente]");
+            return 1;
+        }
+        uint32_t levelSeed = argc >= 5 ? (uint32_t)strtoul(argv[4], NULL, 10) : (uint32_t)time(NULL);
+        return SaveLevelFile(argv[2], atoi(argv[3]), levelSeed) ? 0 : 1;
+    }
+
+    if (argc >= 2 && strcmp(argv[1], "--avaliar") == 0)
+    {
+        if (argc < 4)
+        {
+            TraceLog(LOG_WARNING, "AVISO: uso: --avaliar <mundos> <ticks> [semente]");
+            return 1;
+        }
+        SetRandomSeed(argc >= 5 ? (unsigned int)strtoul(argv[4], NULL, 10) : 1);
+        return RunBatchEvaluation(atoi(argv[2]), atoi(argv[3]));
+    }
+
+    const char *levelPath = NULL;
+    const char *recordPath = NULL;
+    const char *replayPath = NULL;
+    int scriptedTicks = 0;
+    int renderDivisor = 0;
+    for (int i = 1; i < argc; i++)
+    {
+        const char *option = argv[i];
+        if (strncmp(option, "--", 2) != 0)
+        {
+            if (levelPath != NULL)
+            {
+                TraceLog(LOG_WARNING, "AVISO: argumento %s inesperado, nivel ja informado (%s)", option, levelPath);
+                return 1;
+            }
+            levelPath = option;
+            continue;
+        }
+
+        if (strcmp(option, "--gravar") != 0 && strcmp(option, "--reproduzir") != 0 &&
+            strcmp(option, "--roteiro") != 0 && strcmp(option, "--escala") != 0)
+        {
+            TraceLog(LOG_WARNING, "AVISO: opcao %s desconhecida", option);
+            return 1;
+        }
+        if (i + 1 >= argc || strncmp(argv[i + 1], "--", 2) == 0)
+        {
+            TraceLog(LOG_WARNING, "AVISO: opcao %s sem valor", option);
+            return 1;
+        }
+
+        const char *value = argv[++i];
+        if (strcmp(option, "--gravar") == 0)
+            recordPath = value;
+        else if (strcmp(option, "--reproduzir") == 0)
+            replayPath = value;
+        else if (strcmp(option, "--roteiro") == 0)
+        {
+            scriptedTicks = atoi(value);
+            if (scriptedTicks <= 0)
+            {
+                TraceLog(LOG_WARNING, "AVISO: roteiro %s invalido (ticks > 0)", value);
+                return 1;
+            }
+        }
+        else
+            renderDivisor = atoi(value);
+    }
+
+    if (renderDivisor != 0 && (renderDivisor < 1 || renderDivisor > RENDER_SCALE_MAX ||
+                               (renderDivisor & (renderDivisor - 1)) != 0))
+    {
+        TraceLog(LOG_WARNING, "AVISO: escala %d invalida (1 a %d, potencia de 2)", renderDivisor, RENDER_SCALE_MAX);
+        return 1;
+    }
+
+    uint32_t seed = (uint32_t)time(NULL);
+    if (replayPath != NULL)
+    {
+        if (!StartInputReplay(replayPath))
+            return 1;
+        seed = session.seed;
+    }
+    else if (scriptedTicks > 0)
+    {
+        session.scripted = true;
+        session.tickCount = (uint32_t)scriptedTicks;
+        seed = 1;
+    }
+
+    bool headless = session.replaying || session.scripted;
+    if (headless)
+    {
+        SetConfigFlags(FLAG_WINDOW_HIDDEN);
+    }
+
     InitWindow(SCREEN_WIDTH, SCREEN_HEIGHT, "Endless Jumping Game");
-    SetTargetFPS(60);
+    SetTargetFPS(headless ? 0 : 60);
 
     if (!LoadGameAssets())
     {
         TraceLog(LOG_WARNING, "Alguns assets nao carregados, usando fallbacks");
     }
 
-    srand(time(NULL));
-    camera.zoom = 1.0f;
+    if (levelPath != NULL && !LoadLevelFile(levelPath))
+    {
+        TraceLog(LOG_WARNING, "Nivel nao carregado, usando geracao aleatoria");
+    }
+
+    if (recordPath != NULL && !headless)
+    {
+        StartInputRecording(recordPath, seed);
+    }
+
+    SetRandomSeed(seed);
+    world.camera.zoom = 1.0f;
+
+    if (level.map == NULL)
+    {
+        StartPlatformGenerator();
+    }
+
+    if (headless || renderDivisor != 0)
+    {
+        renderScaler.autoScale = false;
+    }
+    if (renderDivisor > 1)
+    {
+        SetRenderDivisor(renderDivisor);
+    }
+    double sessionStart = GetTime();
 
     while (!WindowShouldClose())
     {
+        double frameStart = GetTime();
+        if (gameState != MENU || headless)
+        {
+            ReadInput();
+            if (session.finished)
+                break;
+            if (headless && input.newGame)
+                StartGame();
+        }
+
         switch (gameState)
         {
         case MENU:
             break;
 
         case PLAYING:
+            if (UpdateRewind())
+                break;
             UpdatePlayer();
             UpdateGameCamera();
             UpdatePlatforms();
             CheckGameOver();
+            RewindRecord();
             if (IsKeyPressed(KEY_ESCAPE))
                 gameState = MENU;
             break;
 
         case GAME_OVER:
-            if (IsKeyPressed(KEY_ENTER))
+            if (input.rewind)
+            {
+                gameState = PLAYING;
+                UpdateRewind();
+            }
+            else if (IsKeyPressed(KEY_ENTER))
             {
                 gameState = MENU;
             }
             break;
         }
+        UpdateRenderScale();
+        double drawStart = GetTime();
+        if (gameState != MENU && renderScaler.divisor > 1)
+        {
+            RenderLowResolutionWorld();
+        }
 
         BeginDrawing();
         ClearBackground(SKYBLUE);
@@ -767,28 +2718,28 @@ int main()
             break;
 
         case PLAYING:
-            BeginMode2D(camera);
-            DrawParallaxBackground(gameBackgroundTexture, 0.2f); 
-            DrawPlatforms();
-            DrawPlayer();
-            EndMode2D();
-            DrawHUD();
-            break;
-
         case GAME_OVER:
-            BeginMode2D(camera);
-            DrawParallaxBackground(gameBackgroundTexture, 0.2f); 
-            DrawPlatforms();
-            DrawPlayer();
-            EndMode2D();
-            DrawGameOver();
+            DrawGameplay();
             break;
         }
 
+        renderScaler.updateTime = (float)(drawStart - frameStart);
+        renderScaler.drawTime = (float)(GetTime() - drawStart);
         EndDrawing();
     }
 
+    if (headless && session.tick > 0)
+    {
+        double elapsed = GetTime() - sessionStart;
+        printf("Reproducao: %u ticks %.1f ticks/s %.3f ms/quadro\n",
+               session.tick, session.tick / elapsed, elapsed * 1000.0 / session.tick);
+    }
+
+    StopInputSession();
+    SetRenderDivisor(1);
+    StopPlatformGenerator();
+    UnloadLevelFile();
     UnloadGameAssets();
     CloseWindow();
-    return 0;
+    return session.diverged ? 1 : 0;
 }
\ No newline at end of file